@@ -0,0 +1,375 @@
+/*! ------------------------------------------
+ * @addtogroup Frame_Grabber
+ * @{
+ *
+ * @file    Frame_Grabber.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Implementierung der class @ref frame_grabber.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <strings.h>
+
+#include "Frame_Grabber.hpp"
+
+/*! ----------------------------------------------
+ * @brief Destroy the frame grabber object
+ */
+frame_grabber::~frame_grabber ()
+{
+    stop();
+    cap.release();
+    v4l2.close();
+}
+
+/*! ----------------------------------------------
+ * @brief Kamera öffnen. Der Thread wird erst mit @ref start() gestartet.
+ * @param cam_index Kamera-Nr
+ * @param api z.B. cv::CAP_V4L2
+ * @return true: Kamera ist geöffnet.
+ */
+bool frame_grabber::open (int cam_index, int api)
+{
+    cap.open (cam_index, api);
+    return cap.isOpened();
+}
+
+/*! ----------------------------------------------
+ * @brief Kamera direkt über V4L2 öffnen (@ref v4l2_capture). Der Thread wird erst mit @ref start() gestartet.\n
+ *        BGR liefert V4L2 nicht; bei PIXFMT_BGR wird YUYV eingestellt. Bildgrösse und Format werden 
+ *        hier festgelegt, @ref set() und @ref set_pixfmt() sind danach ohne Wirkung.
+ * @param cam_index Kamera-Nr. Geöffnet wird /dev/video<cam_index>
+ * @param width, height gewünschte Bildgrösse
+ * @param fmt PIXFMT_YUYV oder PIXFMT_MJPG
+ * @param nbufs Anzahl Treiberpuffer. Min. GRAB_RING_SIZE + 2, da jeder Slot im Ring einen Puffer festhält.
+ * @return true: Stream läuft.
+ */
+bool frame_grabber::open_v4l2 (int cam_index, int width, int height, int fmt, int nbufs)
+{
+    if (fmt != PIXFMT_MJPG)
+        fmt = PIXFMT_YUYV;
+    nbufs = std::max (nbufs, GRAB_RING_SIZE + 2);
+
+    if (!v4l2.open (cam_index, width, height, fmt, nbufs))
+        return false;
+    pixfmt = fmt;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Video-Datei oder Verzeichnis mit Bildern (*.jpg, *.jpeg, *.png) öffnen.\n
+ *        Der Grabber arbeitet danach im Replay-Modus: es wird kein Bild verworfen und 
+ *        die Zeitstempel werden aus der Position im Video berechnet.
+ * @param path Datei (AVI, MP4, ...) oder Verzeichnis
+ * @return true: Quelle ist geöffnet.
+ */
+bool frame_grabber::open_file (const std::string &path)
+{
+    struct stat st;
+    if (stat (path.c_str(), &st) != 0)
+        return false;
+
+    replay = true;
+    eof = false;
+    files.clear();
+    file_idx = 0;
+    gettimeofday (&replay_start, NULL);
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir (path.c_str());
+        if (dir == NULL)
+            return false;
+
+        struct dirent *de;
+        while ((de = readdir (dir)) != NULL) {
+            const char *ext = strrchr (de->d_name, '.');
+            if ((ext != NULL) && ((strcasecmp (ext, ".jpg") == 0) || 
+                                  (strcasecmp (ext, ".jpeg") == 0) || 
+                                  (strcasecmp (ext, ".png") == 0)))
+                files.push_back (path + "/" + de->d_name);
+        }
+        closedir (dir);
+        std::sort (files.begin(), files.end());
+
+        if (files.empty())
+            return false;
+        cv::Mat first = cv::imread (files[0]);
+        file_size = first.size();
+        return !first.empty();
+    }
+
+    cap.open (path, cv::CAP_ANY);
+    if (!cap.isOpened())
+        return false;
+
+    double fps = cap.get (cv::CAP_PROP_FPS);
+    if (fps > 0.0)
+        file_fps = fps;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Kamera-Eigenschaft setzen. Darf nur vor @ref start() aufgerufen werden.
+ */
+bool frame_grabber::set (int prop_id, double value)
+{
+    if (th != NULL)
+        return false;
+    return cap.set (prop_id, value);
+}
+
+/*! ----------------------------------------------
+ * @brief Pixelformat der Kamera wählen. Darf nur vor @ref start() aufgerufen werden.\n
+ *        Bei YUYV und MJPEG wird CAP_PROP_CONVERT_RGB abgeschaltet; der Ring enthält dann die Rohdaten
+ *        des Treibers (1 x n CV_8UC1). Die Wandlung übernimmt @ref MotionDetector nur bei Bedarf.
+ * @param fmt PIXFMT_BGR, PIXFMT_YUYV oder PIXFMT_MJPG
+ * @return false: die Kamera unterstützt das Format nicht. Es bleibt bei BGR.
+ */
+bool frame_grabber::set_pixfmt (int fmt)
+{
+    if (v4l2.is_open())                 // Format steht seit open_v4l2() fest
+        return fmt == pixfmt;
+    if ((th != NULL) || replay || !cap.isOpened())
+        return false;
+
+    if (fmt == PIXFMT_BGR) {
+        cap.set (cv::CAP_PROP_CONVERT_RGB, 1);
+        pixfmt = PIXFMT_BGR;
+        return true;
+    }
+
+    int fourcc = (fmt == PIXFMT_YUYV) ? cv::VideoWriter::fourcc ('Y', 'U', 'Y', 'V') 
+                                      : cv::VideoWriter::fourcc ('M', 'J', 'P', 'G');
+    if (!cap.set (cv::CAP_PROP_FOURCC, fourcc) || ((int)cap.get (cv::CAP_PROP_FOURCC) != fourcc))
+        return false;
+    if (!cap.set (cv::CAP_PROP_CONVERT_RGB, 0))
+        return false;
+
+    pixfmt = fmt;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Kamera-Eigenschaft lesen. Darf nur vor @ref start() aufgerufen werden.
+ */
+double frame_grabber::get (int prop_id)
+{
+    if (th != NULL)
+        return 0.0;
+
+    if (!files.empty()) {       // Verzeichnis mit Bildern
+        if (prop_id == cv::CAP_PROP_FRAME_WIDTH)
+            return file_size.width;
+        if (prop_id == cv::CAP_PROP_FRAME_HEIGHT)
+            return file_size.height;
+        return 0.0;
+    }
+    if (v4l2.is_open()) {       // --capture v4l2
+        if (prop_id == cv::CAP_PROP_FRAME_WIDTH)
+            return v4l2.get_width();
+        if (prop_id == cv::CAP_PROP_FRAME_HEIGHT)
+            return v4l2.get_height();
+        if (prop_id == cv::CAP_PROP_FPS)
+            return v4l2.get_fps();
+        return 0.0;
+    }
+    return cap.get (prop_id);
+}
+
+/*! ----------------------------------------------
+ * @brief Grabber-Thread starten.
+ * @return EXIT_SUCCESS oder EXIT_FAILURE, wenn keine Kamera geöffnet ist.
+ */
+int frame_grabber::start ()
+{
+    if (!cap.isOpened() && files.empty() && !v4l2.is_open())
+        return EXIT_FAILURE;
+    if (th != NULL)
+        return EXIT_SUCCESS;        // läuft schon
+
+    ende = false;
+    th = new std::thread (run, this);
+    return EXIT_SUCCESS;
+}
+
+/*! ----------------------------------------------
+ * @brief Grabber-Thread beenden.
+ */
+void frame_grabber::stop ()
+{
+    if (th == NULL)
+        return;
+
+    ende = true;
+    th->join();
+    delete th;
+    th = NULL;
+    cv_frame.notify_all();
+}
+
+/*! ----------------------------------------------
+ * @brief Replay-Modus: nächstes Bild aus Datei oder Verzeichnis lesen.\n
+ *        Der Zeitstempel ergibt sich aus der Position im Video bzw. aus der Bild-Nr.
+ * @return false: Ende der Quelle erreicht.
+ */
+bool frame_grabber::read_next (cv::Mat &dst, struct timeval *tv)
+{
+    double pos_ms = -1.0;
+
+    if (!files.empty()) {
+        if (file_idx >= files.size())
+            return false;
+        dst = cv::imread (files[file_idx++]);
+        if (dst.empty())
+            return false;
+    } else {
+        if (!cap.read (dst))
+            return false;
+        pos_ms = cap.get (cv::CAP_PROP_POS_MSEC);
+    }
+
+    if (pos_ms < 0.0)
+        pos_ms = (double)captured * 1000.0 / file_fps;
+
+    long long us = (long long)replay_start.tv_usec + (long long)(pos_ms * 1000.0);
+    tv->tv_sec = replay_start.tv_sec + us / 1000000ll;
+    tv->tv_usec = us % 1000000ll;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief --capture v4l2: nächstes Bild vom Treiber holen, ohne Kopie.\n
+ *        Ein Slot hält seinen Treiberpuffer, bis der Grabber den Slot wieder beschreibt. Erst dann
+ *        ist sicher, dass @ref get_newest() ihn nicht mehr liest, und der Puffer geht an den Treiber zurück.
+ * @param slot freier Slot oder NULL, wenn der Ring voll ist. Das Bild wird dann sofort zurückgegeben.
+ * @return false: kein Bild (Timeout oder Fehler) oder Bild verworfen.
+ */
+bool frame_grabber::read_v4l2 (struct _frame_ *slot)
+{
+    if ((slot != NULL) && (slot->buf >= 0)) {
+        v4l2.requeue (slot->buf);
+        slot->buf = -1;
+        slot->image.release();          // nur der Header, der Speicher gehört dem Treiber
+    }
+
+    struct timeval tv;
+    int idx;
+    if (!v4l2.dequeue ((slot != NULL) ? slot->image : scratch, &tv, &idx)) {   // wartet max. V4L2_TIMEOUT ms
+        ++read_error;
+        return false;
+    }
+    ++captured;
+
+    if (slot == NULL) {                 // Ring voll: Bild verwerfen
+        v4l2.requeue (idx);
+        ++overrun;
+        return false;
+    }
+    slot->buf = idx;
+    slot->tv = tv;                      // Zeitstempel des Kernels
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Thread: liest die Kamera so schnell aus, wie sie liefert.\n
+ *        Ist der Ring voll, wird das Bild trotzdem gelesen (Treiberpuffer leeren) und verworfen.\n
+ *        Im Replay-Modus wird gewartet, bis im Ring Platz ist. Am Ende der Quelle wird der Thread beendet.
+ */
+void frame_grabber::run (frame_grabber *g)
+{
+    while (!g->ende) {
+        struct _frame_ *slot = g->ring.write_slot();
+
+        if (g->replay) {
+            if (slot == NULL) {                 // Ring voll: warten, kein Bild verwerfen
+                usleep (500);
+                continue;
+            }
+            if (!g->read_next (slot->image, &slot->tv)) {
+                {
+                    std::lock_guard<std::mutex> lk(g->mtx);
+                    g->eof = true;
+                }
+                g->cv_frame.notify_all();
+                break;
+            }
+            ++g->captured;
+        } else if (g->v4l2.is_open()) {
+            if (!g->read_v4l2 (slot))
+                continue;
+        } else {
+            cv::Mat &target = (slot != NULL) ? slot->image : g->scratch;
+
+            if (!g->cap.read (target)) {        // blockiert bis das nächste Bild da ist
+                ++g->read_error;
+                usleep (10000);
+                continue;
+            }
+            ++g->captured;
+
+            if (slot == NULL) {                 // Ring voll: Bild verwerfen
+                ++g->overrun;
+                continue;
+            }
+
+            gettimeofday (&slot->tv, NULL);     // Aufnahme-Zeitpunkt festhalten
+        }
+
+        slot->nr = g->captured;
+        {
+            std::lock_guard<std::mutex> lk(g->mtx);
+            g->ring.commit();
+        }
+        g->cv_frame.notify_one();
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Holt das neueste Bild aus dem Ring. Ältere Bilder werden verworfen.\n
+ *        Im Replay-Modus wird kein Bild übersprungen; es wird das älteste Bild geliefert.
+ * @param dst Ziel. Das Bild wird kopiert; dst gehört danach allein dem Aufrufer.
+ * @param tv Aufnahme-Zeitpunkt. Darf NULL sein.
+ * @param timeout_ms Max. Wartezeit in [ms], falls noch kein neues Bild vorliegt.
+ * @return false: Timeout oder Ende der Quelle (@ref is_eof()). Es liegt kein Bild vor.
+ */
+bool frame_grabber::get_newest (cv::Mat &dst, struct timeval *tv, int timeout_ms)
+{
+    if (ring.empty()) {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv_frame.wait_for (lk, std::chrono::milliseconds(timeout_ms),
+                           [this]{ return !ring.empty() || ende.load() || eof.load(); });
+    }
+
+    size_t n = 0;
+    struct _frame_ *slot = (replay) ? ring.read_slot() : ring.newest_slot (&n);
+    if (slot == NULL)
+        return false;
+
+    skipped += n;
+    slot->image.copyTo (dst);           // Slot-Puffer wird vom Grabber wiederverwendet. --capture v4l2: einzige Kopie
+    if (tv != NULL)
+        *tv = slot->tv;
+    ring.release();
+
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Statistik im Terminal anzeigen.
+ */
+void frame_grabber::show_stat ()
+{
+    cout << "-------- frame grabber ---------\n";
+    cout << "captured:   " << captured << endl;
+    cout << "overrun:    " << overrun << endl;
+    cout << "skipped:    " << skipped << endl;
+    cout << "read error: " << read_error << endl;
+}
+
+//! @} Frame_Grabber
@@ -0,0 +1,126 @@
+/*! ------------------------------------------
+ * @defgroup Frame_Grabber Frame_Grabber: Bildeinzug in einem eigenen Thread
+ * @{
+ *
+ * @file    Frame_Grabber.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Class für den Bildeinzug.\n
+ * Ein eigener Thread besitzt die cv::VideoCapture und liest die Kamera mit ihrer nativen Framerate aus.
+ * Jedes Bild wird mit Zeitstempel in einen lock-freien @ref spsc_ring abgelegt.
+ * Die Bewegungserkennung holt sich mit @ref frame_grabber::get_newest() immer das neueste Bild.
+ * Ältere, nicht abgeholte Bilder werden verworfen und gezählt.\n
+ * Mit @ref frame_grabber::open_file() liest der Grabber ein Video oder ein Verzeichnis mit Bildern (Replay-Modus).
+ * Im Replay-Modus wird kein Bild verworfen. Der Grabber wartet, bis im Ring wieder Platz ist.\n
+ * Mit @ref frame_grabber::set_pixfmt() liefert die Kamera YUYV oder MJPEG ohne Wandlung nach BGR.\n
+ * Mit @ref frame_grabber::open_v4l2() wird die Kamera ohne cv::VideoCapture über @ref v4l2_capture gelesen.
+ * Die Slots im Ring zeigen dann direkt auf die Treiberpuffer; der Zeitstempel kommt vom Kernel.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef FRAME_GRABBER_HPP
+#define FRAME_GRABBER_HPP
+
+#include <iostream>
+#include <stdint.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+#include "spsc_ring.hpp"
+#include "v4l2_capture.hpp"
+
+using namespace std;
+
+#define GRAB_RING_SIZE 4        //!< Anzahl Slots im Ringpuffer des @ref frame_grabber. Muss eine 2er-Potenz sein.
+
+#define PIXFMT_BGR 0            //!< OpenCV wandelt jedes Bild nach BGR. Option --pixfmt bgr
+#define PIXFMT_YUYV 1           //!< Rohdaten YUYV 4:2:2, 1 x (2 * Breite * Höhe) CV_8UC1. Option --pixfmt yuyv
+#define PIXFMT_MJPG 2           //!< Rohdaten MJPEG, 1 x n CV_8UC1. Option --pixfmt mjpg
+
+#define CAPTURE_CV 0            //!< Bildeinzug mit cv::VideoCapture. Option --capture cv
+#define CAPTURE_V4L2 1          //!< Bildeinzug mit @ref v4l2_capture, MMAP-Puffer ohne Kopie. Option --capture v4l2
+
+/*! -------------------------------
+ * @brief Ein Kamerabild mit Aufnahme-Zeitpunkt.
+ */
+struct _frame_ {
+    cv::Mat image;              //!< BGR-Bild oder Rohdaten. @see @ref frame_grabber::set_pixfmt()
+    struct timeval tv;          //!< Aufnahme-Zeitpunkt
+    uint64_t nr;                //!< laufende Bild-Nr. des Grabbers
+    int buf = -1;               //!< --capture v4l2: Nr. des Treiberpuffers, auf den image zeigt. -1: keiner
+};
+
+/*! -------------------------------
+ * @brief class für den Bildeinzug in einem eigenen Thread.
+ */
+class frame_grabber {
+public:
+    frame_grabber (): th(NULL), ende(false), eof(false), captured(0), overrun(0), skipped(0), read_error(0) {}
+    ~frame_grabber ();
+
+    frame_grabber (frame_grabber&) = delete;
+    void operator= (frame_grabber&) = delete;
+
+    bool open (int cam_index, int api = cv::CAP_V4L2);
+    bool open_file (const std::string &path);
+    bool open_v4l2 (int cam_index, int width, int height, int fmt, int nbufs = V4L2_BUFS);
+    int start ();
+    void stop ();
+    bool is_running () { return th != NULL; }
+    bool is_replay () { return replay; }
+    bool is_v4l2 () { return v4l2.is_open(); }
+    bool is_eof () { return eof.load() && ring.empty(); }
+
+    bool set (int prop_id, double value);       // nur vor start() verwenden !
+    bool set_pixfmt (int fmt);                  // nur vor start() verwenden !
+    int get_pixfmt () { return pixfmt; }
+    double get (int prop_id);                   // nur vor start() verwenden !
+
+    bool get_newest (cv::Mat &dst, struct timeval *tv = NULL, int timeout_ms = 1000);
+
+    uint64_t get_captured () { return captured.load(); }
+    uint64_t get_dropped () { return overrun.load() + skipped.load(); }
+    void show_stat ();
+
+private:
+    static void run (frame_grabber *g);
+    bool read_next (cv::Mat &dst, struct timeval *tv);
+    bool read_v4l2 (struct _frame_ *slot);
+
+    cv::VideoCapture cap;               //!< Kamera. Gehört nach @ref start() ausschliesslich dem Grabber-Thread.
+    v4l2_capture v4l2;                  //!< Kamera bei --capture v4l2. Gehört nach @ref start() ausschliesslich dem Grabber-Thread.
+    spsc_ring <struct _frame_, GRAB_RING_SIZE> ring;    //!< Übergabe der Bilder an die Bewegungserkennung
+    cv::Mat scratch;                    //!< Wird bei vollem Ring zum Leeren des Treiberpuffers verwendet.
+    int pixfmt = PIXFMT_BGR;            //!< Format der Bilder im Ring. @see @ref set_pixfmt()
+    std::thread *th;                    //!< Grabber-Thread
+    std::atomic<bool> ende;             //!< true beendet den Grabber-Thread
+    std::mutex mtx;                     //!< Nur für das Aufwecken in @ref get_newest(). Der Ring selbst ist lock-frei.
+    std::condition_variable cv_frame;
+
+    // ------------- Replay-Modus --------------
+    bool replay = false;                //!< true: Quelle ist eine Datei oder ein Verzeichnis. @see @ref open_file()
+    std::vector<std::string> files;     //!< Bilddateien, wenn die Quelle ein Verzeichnis ist. Sortiert nach Namen.
+    size_t file_idx = 0;                //!< nächste Datei in @ref files
+    cv::Size file_size;                 //!< Bildgrösse des ersten Bildes in @ref files
+    double file_fps = 10.0;             //!< Framerate für die Zeitstempel im Replay-Modus
+    struct timeval replay_start;        //!< Zeitstempel des ersten Bildes im Replay-Modus
+    std::atomic<bool> eof;              //!< Replay-Modus: alle Bilder gelesen
+
+    std::atomic<uint64_t> captured;     //!< Anzahl eingelesener Bilder
+    std::atomic<uint64_t> overrun;      //!< Ring war voll. Bild wurde vom Grabber verworfen.
+    std::atomic<uint64_t> skipped;      //!< Bild wurde von @ref get_newest() übersprungen.
+    std::atomic<uint64_t> read_error;   //!< cv::VideoCapture::read() bzw. @ref v4l2_capture::dequeue() ist fehlgeschlagen.
+};
+
+#endif
+
+//! @} Frame_Grabber
@@ -0,0 +1,1068 @@
+/*! ------------------------------------------
+ * @addtogroup MotionDetector
+ * @{
+ *
+ * @file    MotionDetector.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Implementierung der class @ref MotionDetector.
+ *
+ * @copyright Copyright (c) 2021, 2022, 2023, 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "MotionDetector.hpp"
+#include "histogram.h"
+#include "morph.hpp"
+#include "pixdiff.hpp"
+#include "preproc.hpp"
+#include "tile_blobs.hpp"
+#include "timefunc.hpp"
+
+// #define USE_CVD      //!< used by OpenCVD @see https://github.com/ubuettemeier/OpenCVD
+
+#ifdef USE_CVD
+    #include "../../OpenCVD/include/opencvd.hpp"
+    #include "../../OpenCVD/include/specdef.hpp"
+#else 
+    #define CVD cv
+#endif
+
+using namespace std;
+using namespace cv;
+
+/*! --------------------------------------------------------------
+ * @brief Construct a new MotionDetector object
+ */
+MotionDetector::MotionDetector ()
+{
+    seg_NonZero = cv::Mat (VERT_TEILER, HORZ_TEILER, CV_8UC1, cv::Scalar(0));
+    seg_xe.assign (1, 0);       // Feldgrenzen werden in make_seg() berechnet
+    seg_ye.assign (1, 0);
+    pic_name[0] = '\0';
+
+#ifdef USE_FEATURE_DETECTOR
+    // detector = cv::FastFeatureDetector::create(0);
+    detector = cv::FastFeatureDetector::create(25, false, FastFeatureDetector::TYPE_7_12);
+#endif
+}
+
+/*! ----------------------------------------
+ * @brief struct _geo_ wird mit Screen-Abmessung belegt.
+ * @param wish Gewünschter Bildausschnitt. Werte < 0 werden durch die Bildgrenzen ersetzt.
+ * @param fwidth Kamera Bildbreite
+ * @param fheight Kamera Bildhöhe
+ */
+void MotionDetector::reset_geo (const struct _geo_ &wish, int fwidth, int fheight)
+{
+    frame_w = fwidth;
+    frame_h = fheight;
+    geo.left = (wish.left >= 0) ? wish.left : 0;
+    geo.top = (wish.top !=-1) ? wish.top : 0;
+    geo.right = (wish.right !=-1) ? wish.right : fwidth-1;
+    geo.bottom = (wish.bottom !=-1) ? wish.bottom : fheight-1;
+
+    // Plausibilitätsprüfung
+    if ((geo.left > fwidth-1) || (geo.left >= geo.right)) {
+        cout << "ERROR Parameter --left out of range. --left wird auf 0 gesetzt\n";
+        geo.left = 0;
+    }
+    if ((geo.right > fwidth-1) || (geo.right <= geo.left)) {
+        cout << "ERROR Parameter --right out of range. --right wird auf MAX gesetzt\n";
+        geo.right = fwidth - 1;
+    }
+    if ((geo.top > fheight-1) || (geo.top >= geo.bottom)) {
+        cout << "ERROR Parameter --top out of range. --top wird auf 0 gesetzt\n";
+        geo.top = 0;
+    }
+    if ((geo.bottom > fheight-1) || (geo.bottom <= geo.top)) {
+        cout << "ERROR Parameter --bottom out of range. --bottom wird auf MAX gesetzt\n";
+        geo.bottom = fheight-1;
+    }
+
+    // Das Mosaik arbeitet auf dem halb so grossen ROI. Ein Feld muss mind. 1 Pixel haben.
+    int max_x = (geo.right - geo.left + 1) / 2;
+    int max_y = (geo.bottom - geo.top + 1) / 2;
+    if (properties.grid_x > max_x) {
+        cout << "ERROR Parameter --grid: zu viele Felder in X. Wird auf " << max_x << " gesetzt\n";
+        properties.grid_x = max_x;
+    }
+    if (properties.grid_y > max_y) {
+        cout << "ERROR Parameter --grid: zu viele Felder in Y. Wird auf " << max_y << " gesetzt\n";
+        properties.grid_y = max_y;
+    }
+}
+
+/*! --------------------------------------------------------------
+ * @brief Prüft ob Datei vorhanden ist.
+ * @return 1: Datei vorhanden\n
+ *         0: keine Datei gefunden
+ */
+static inline bool file_exists (const std::string& fname) 
+{
+    ifstream f(fname.c_str());  // input file streams
+    return f.good();
+}
+
+/*! --------------------------------------------------------------------
+ * @brief   Funktion sucht die höchste Tages-Video-Nr, z.B out12.avi oder out12.mkv\n
+ *          Es wird dann die nächste Nr als aktueller vid_counter definiert.\n
+ *          Mit @ref storage kommt die Nr. aus dem Index.
+ */
+void MotionDetector::init_vid_counter()
+{
+    if (sv.get_storage() != NULL) {             // Nr. aus dem Index, ohne stat() je Nr.
+        vid_counter = sv.get_storage()->next_index (folder);
+        return;
+    }
+
+    int n=0;
+    bool treffer = false;
+    char buf[512];
+
+    const int conts[] = { SV_CONT_AVI, SV_CONT_MKV, SV_CONT_MP4 };   // Nr. läuft über alle Container weiter
+    while ((n<1000) && !treffer) {
+        bool exists = false;
+        if (!properties.only_picture) {
+            for (int c : conts) {
+                sprintf (buf, "%s/out%i.%s", folder.c_str(), n, sv_encoder::ext (c));   // video-mode
+                exists = exists || file_exists(buf);
+            }
+        } else {
+            sprintf (buf, "%s/out%i.jpg", folder.c_str(), n);   // picture-mode
+            exists = file_exists(buf);
+        }
+
+        if (exists) 
+            ++n;
+        else 
+            treffer = true;
+    }
+
+    if (treffer)
+       vid_counter = n;
+}
+
+
+/*! -----------------------------------------------------------
+ * @brief 
+ */
+cv::Mat MotionDetector::make_ausgabe_screen (cv::Mat src, cv::Mat seg_screen)
+{
+    cv::Mat src_2;
+    if (seg_screen.type() == CV_8UC1)
+        cv::cvtColor (seg_screen, src_2, cv::COLOR_GRAY2BGR);       // Farbbild erzeugen => src2
+    else 
+        seg_screen.copyTo(src_2);                                   // seg_screen copy to => src2
+
+
+    cv::Mat foo = cv::Mat (std::max (src.rows, src_2.rows), src.cols + src_2.cols+10, CV_8UC3);    // Gesamtbild = src + seg_screen
+    foo = cv::Scalar(255, 255, 255);                                        // Gesamtbild = white
+    cv::Mat roi(foo, cv::Rect(0, 0, src.cols, src.rows));                   // ROI for src
+
+    // Sensitiven Bildausschnitt zeichnen
+    if ((geo.left != 0) || (geo.top != 0) || (geo.right != src.cols-1) || (geo.bottom != src.rows-1))
+        cv::rectangle (src, 
+                    cv::Point (geo.left, geo.top), cv::Point (geo.right, geo.bottom),
+                    cv::Scalar(0, 0, 255), 
+                    1);
+                
+    src.copyTo (roi);   // src ind Videobild eintragen
+    cv::Mat roi2(foo, cv::Rect(src.cols+5, 0, src_2.cols, src_2.rows));     // ROI for seg_screen (src_2)
+    src_2.copyTo (roi2);    // seg_screen in Videobild eintragen
+
+    return foo;
+}
+
+/*! -----------------------------------------------------------
+ * @brief Bild für Video und Pre-Roll.\n
+ *        --record raw: das Kamerabild selbst, ohne Kopie und ohne Overlay.
+ *        --record composite: Kamerabild und Contour-Bild nebeneinander. @see @ref make_ausgabe_screen()
+ */
+cv::Mat MotionDetector::record_image ()
+{
+    if (properties.record == RECORD_RAW)
+        return get_src_image();
+    return make_ausgabe_screen (get_src_image(), get_contours_pic());
+}
+
+/*! -----------------------------------------------------------
+ * @brief Zusatztext für Video und Pre-Roll: Differenz-Pixel.\n
+ *        Bei --record raw zusätzlich die Blobs (x,y BxH in Pixeln des Kamerabildes). Der Text landet dort
+ *        als Untertitel in der .vtt-Datei. @see @ref save_video::set_sidecar()
+ */
+void MotionDetector::record_text (char *buf, size_t n)
+{
+    int len = snprintf (buf, n, "%i pix", abs(properties.diff_non_zero));
+    if (properties.record != RECORD_RAW)
+        return;
+
+    for (size_t i=0; (i<blobs.size()) && (len > 0) && ((size_t)len < n); i++) {
+        const cv::Rect &r = blobs[i].pix;
+        len += snprintf (buf + len, n - len, " | %i,%i %ix%i", r.x, r.y, r.width, r.height);
+    }
+}
+
+/*! -------------------------------------------------------
+ * 
+ */
+void MotionDetector::write_diff_non_zero_to_diff ()
+{
+    char buf[256];
+
+    sprintf (buf, "%i", properties.diff_non_zero);
+    cv::putText(diff,                    // target image
+                buf,                            // text
+                cv::Point(10, 20),              // top-left position
+                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
+                1.0,                            // fontScale
+                255,                            // font color
+                2);                             // thickness
+}
+
+/*! -------------------------------------------------
+ * @brief   Funktion erzeugt aus <src> ein Mosaik mit properties.grid_x x properties.grid_y Feldern.\n
+ *          Die Differenzpixel aller Mosaik-Felder werden mit @ref pixdiff::tiles() in einem Durchlauf gezählt.
+ *          Der Rest der Teilung wird auf die Felder verteilt (@ref pixdiff::tile_edges()), die Ränder gehen nicht verloren.
+ */
+void MotionDetector::make_seg (cv::Mat basis)
+{
+    const int gx = properties.grid_x;
+    const int gy = properties.grid_y;
+
+    // ------------ Mosaik einrichten -------------------   
+    seg_in[first_in] = basis;           // kein Kopieren. basis wird in detect() nicht mehr verändert.
+    if ((seg_NonZero.rows != gy) || (seg_NonZero.cols != gx) || (seg_xe.back() != basis.cols) || (seg_ye.back() != basis.rows)) {
+        seg_NonZero = cv::Mat (gy, gx, CV_8UC1, cv::Scalar(0));
+        seg_count.assign (gx * gy, 0);
+        seg_xe.resize (gx + 1);
+        seg_ye.resize (gy + 1);
+        pixdiff::tile_edges (basis.cols, gx, seg_xe.data());
+        pixdiff::tile_edges (basis.rows, gy, seg_ye.data());
+        seg_w = basis.cols / gx;        // kleinste Feldgrösse
+        seg_h = basis.rows / gy;
+    }
+
+    // ------------- Differenz NonZero für jedes Mosaik-Bild ermitteln -----------
+    seg_NonZero = 0;    // cv::Mat auf 0 setzen !!!
+    if (!seg_in[last_in].empty() && (seg_in[last_in].size() == basis.size())) {
+        pixdiff::tiles (seg_in[first_in], seg_in[last_in], gx, gy, (uint8_t)properties.threshold, seg_count.data(),
+                        properties.threads);        // Bänder parallel, Ergebnis wie seriell
+
+        for (int y=0; y<gy; y++) {
+            for (int x=0; x<gx; x++) {
+                // -------- Nachschauen, ob Anzahl Farb-Pixel grösser ist als properties.NonZero_seg ---------
+                if (seg_count[y * gx + x] > properties.NonZero_seg)  // --pixdiff für Mosaik, default 25
+                    seg_NonZero.at<uchar>(y, x) = 128;
+            }
+        }
+    }
+
+    label_blobs ();
+
+#ifdef SHOW_MOSAIK
+    // --------------- Mosaik - Bild erzeugen ---------------------
+    show_seg = cv::Mat(basis.rows + 5*gy+5,     // rows
+                       basis.cols + 5*gx+5,     // cols
+                       CV_8UC3 );
+    show_seg = cv::Scalar (255, 255, 255);
+    for (int y=0; y<gy; y++) {
+        for (int x=0; x<gx; x++) {
+            if (!seg_in[last_in].empty()) {
+                cv::Rect r (seg_xe[x], seg_ye[y], seg_xe[x+1]-seg_xe[x], seg_ye[y+1]-seg_ye[y]);
+                cv::Rect t (r.x+5*x+5, r.y+5*y+5, r.width, r.height);
+                cv::Mat foo(show_seg, t);
+                cv::Mat dummy;
+                seg_in[first_in](r).copyTo ( dummy );
+                cv::cvtColor (dummy, dummy, cv::COLOR_GRAY2BGR);
+                dummy.copyTo ( foo );
+                if (seg_NonZero.at<uchar>(y, x))
+                    cv::rectangle (show_seg, t, cv::Scalar(0, 0, 255), 3);
+            }
+        }
+    }
+#endif
+}
+
+/*! -------------------------------------------------
+ * @brief   Zusammenhängende aktive Felder in @ref seg_NonZero zu Blobs zusammenfassen.\n
+ *          Das Contour-Bild wird erst bei Bedarf in @ref get_contours_pic() gezeichnet.
+ */
+void MotionDetector::label_blobs ()
+{
+    // Mosaik-Feld in Pixeln des Kamerabildes: seg_in ist durch pyrDown() halb so gross wie der ROI.
+    cv::Size2f cell (seg_xe.back() * 2.0f / properties.grid_x, seg_ye.back() * 2.0f / properties.grid_y);
+    tile_blobs::label (seg_NonZero, cell, cv::Point (geo.left, geo.top), blobs);
+
+    float cx = 0.0f;
+    for (size_t i=0; i<blobs.size(); i++)
+        cx += blobs[i].center.x;
+    if (!blobs.empty())
+        contour_x_center = cx / blobs.size() * contour_scale();
+
+    contours_valid = false;
+}
+
+/*! -------------------------------------------------
+ * @brief   Vergrösserung des Mosaiks für das Contour-Bild. Das Bild bleibt bei jedem --grid
+ *          innerhalb CONTOUR_W x CONTOUR_H (Default 8x6: Faktor 40).
+ */
+float MotionDetector::contour_scale ()
+{
+    return std::min ((float)CONTOUR_W / seg_NonZero.cols, (float)CONTOUR_H / seg_NonZero.rows);    // Mosaik = --grid
+}
+
+/*! -------------------------------------------------
+ * @brief   Contour-Bild mit den Schwerpunkten der Blobs. Wird nur gezeichnet, wenn es gebraucht wird
+ *          (Bildschirmausgabe, Video, Pre-Roll) und sich seit dem letzten Aufruf etwas geändert hat.
+ * @return  @ref contours_pic
+ */
+cv::Mat &MotionDetector::get_contours_pic ()
+{
+    if (contours_valid)
+        return contours_pic;
+
+    // ------------------------- Contours ---------------------------------------------
+    const float f = contour_scale();
+    cv::resize (seg_NonZero, contours_pic, 
+                cv::Size (cvRound (seg_NonZero.cols * f), cvRound (seg_NonZero.rows * f)), 0, 0, cv::INTER_NEAREST);
+
+    for (size_t i=0; i<blobs.size(); i++) {
+        cv::Point c (blobs[i].center.x * f, blobs[i].center.y * f);
+        cv::circle (contours_pic, c, 5, 255, 1);    
+    }
+
+    cv::line (contours_pic, cv::Point(contour_x_center, 0), cv::Point (contour_x_center, contours_pic.rows-1), 255, 1);
+
+    char buf[256];
+    sprintf (buf, "%ld  %2.1f%c", static_cast<long int>(blobs.size()), (float)contour_x_center / (float)contours_pic.cols * 100.f, '%');
+    cv::putText(contours_pic,                   // target image
+                buf,                            // text
+                cv::Point(10, 20),              // top-left position
+                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
+                1.0,                            // fontScale
+                255,                            // font color
+                2);                             // thickness
+
+    contours_valid = true;
+    return contours_pic;
+}
+
+/*! ----------------------------------------------------------------------------------
+ * @brief Funktion vergleicht die Option `properties.NonZero_seg` mit der kleinsten Mosaikfläche (seg_w * seg_h).
+ *
+ * Diese Funktion überprüft, ob der Wert von `properties.NonZero_seg` größer oder gleich
+ * der Anzahl der Pixel in der Mosaikfläche ist. Wenn dies der Fall ist, wird eine Warnung
+ * ausgegeben und der Wert von `properties.NonZero_seg` auf die Mosaikfläche minus 1
+ * zurückgesetzt. Anschließend gibt die Funktion den Wert von `properties.NonZero_seg` zurück.
+ *
+ * @return Der Wert von `properties.NonZero_seg` nach der Überprüfung.
+ */
+int MotionDetector::check_pixdiff ()
+{
+    int anz_pix = seg_w * seg_h;
+
+    if (properties.NonZero_seg >= anz_pix) {
+        cout << "WARNING: --pixdiff ist > als Mosaik-Fläche\n";
+        cout << "Mosaik-Fläche: " << seg_w << " / " << seg_h << " = " << anz_pix << endl;
+        cout << "--pixdiff: " << properties.NonZero_seg << endl; 
+        cout << "--pixdiff wird zurückgesetzt auf Mosaik-Fläche-1\n";
+        properties.NonZero_seg = std::max (anz_pix - 1, 0);     // Vergleich ist '>': sonst wird nie ein Feld aktiv
+    }
+
+    return properties.NonZero_seg;
+}
+
+/*! ----------------------------------------------------------
+ * @brief Gibt die Anzahl der sensitiven Pixel zurück.
+ *
+ * Diese Funktion berechnet die Anzahl der sensitiven Pixel in einem Bild. \n
+ * Die Berechnung ergibt sich aus (sensetive Fläche - ignor Fläche) \n
+ * Die sensetive Fläche ist @ref geo gespeichert. Die ignor Fläche ist in @ref ignor_geo gesichert.
+ * 
+ * @return Die Anzahl der sensitiven Pixel.
+ */
+int MotionDetector::get_anzahl_sensetive_pixel()
+{
+    cv::Mat foo (frame_h, frame_w, CV_8UC1, cv::Scalar(0));
+    cv::rectangle (foo, cv::Rect(geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1), 255, -1);
+    if (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0) {
+        cv::rectangle (foo, 
+                       cv::Rect (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight),
+                       cv::Scalar(0), 
+                       -1);
+    }
+
+    return cv::countNonZero(foo);
+}
+
+/*! -------------------------------------------------
+ * @brief   Monotone Zeit in [us]. Wird von Uhrzeit-Änderungen (NTP, Sommerzeit) nicht beeinflusst.
+ */
+static long long mono_us ()
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000ll + t.tv_nsec / 1000;
+}
+
+/*! -------------------------------------------------
+ * @brief   Beginn der nächsten Periode (CLOCK_MONOTONIC in [us]).\n
+ *          Die Periode zählt ab dem Beginn der letzten Periode; die Rechenzeit wird also abgezogen und
+ *          die Framerate driftet nicht mit der Last. Ist die Auswertung zu langsam, wird nicht nachgeholt.\n
+ *          Nach IDLE_TIME ms ohne Differenz-Pixel wird mit properties.idle_fps ausgewertet, 
+ *          bei der ersten Differenz sofort wieder mit properties.fps.
+ * @return Termin für das nächste @ref get_frame(). Bei mehreren Kameras der Termin im @ref worker_pool.
+ */
+long long MotionDetector::get_due ()
+{
+    long long t = mono_us ();
+
+    bool quiet = (state == 0) && (properties.idle_fps > 0) && (properties.idle_fps < properties.fps) &&
+                 (t - active_us > IDLE_TIME * 1000ll);
+    if (quiet != idle) {
+        idle = quiet;
+        if (!properties.no_output) 
+            cout << ((idle) ? "idle: " : "aktiv: ") << ((idle) ? properties.idle_fps : properties.fps) << " fps\n";
+    }
+    properties.frame_delay = 1000000 / ((idle) ? properties.idle_fps : properties.fps);
+
+    long long next = tick_us + properties.frame_delay;
+    if ((tick_us == 0) || (next <= t))          // erstes Bild oder Periode schon vorbei
+        return t;
+    return next;
+}
+
+/*! -------------------------------------------------
+ * @brief   Takt der Auswertung. Wartet bis zum Termin aus @ref get_due().
+ */
+void MotionDetector::pace ()
+{
+    long long next = get_due ();
+
+    struct timespec ts;
+    ts.tv_sec = next / 1000000ll;
+    ts.tv_nsec = (next % 1000000ll) * 1000;
+    while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+    tick_us = next;
+}
+
+/*! -------------------------------------------------
+ * @brief   Bildeinzug und Bewegungserkennung.
+ *
+ * Nach dem Takt aus @ref pace() wird das neueste Bild aus dem @ref grabber geholt und mit @ref detect() ausgewertet.
+ * Zeigt das Vorschaubild keine Änderung, wird die Auswertung übersprungen. @see @ref skip_frame()
+ * @return false: es liegt kein neues Bild vor.
+ */
+bool MotionDetector::get_frame()
+{
+    struct timeval tv;
+
+    properties.falle_aktiv = false;
+
+    if (grabber == NULL)
+        return false;
+    if (pooled)                                     // Takt kommt vom worker_pool. @see get_due()
+        tick_us = mono_us ();
+    else if (!properties.replay)                    // Replay: so schnell wie möglich
+        pace ();
+    const int fmt = grabber->get_pixfmt();
+    if (!grabber->get_newest ((fmt == PIXFMT_BGR) ? src_image : raw, &tv, (pooled) ? 0 : 1000))    // Bildeinzug: neuestes Bild aus dem Grabber-Ring
+        return false;                                   // kein neues Bild. Ringzähler bleiben stehen.
+
+    raw_fmt = fmt;
+    src_valid = (fmt == PIXFMT_BGR);                    // Rohdaten: BGR erst bei Bedarf. @see get_src_image()
+    if (!decode_raw ())
+        return false;
+
+    if (!skip_frame (tv))
+        detect (tv);
+
+    if ((properties.diff_non_zero != 0) || properties.falle_aktiv)
+        active_us = mono_us ();                     // Bewegung: sofort wieder volle Framerate
+    return true;
+}
+
+/*! -------------------------------------------------
+ * @brief   Vorfilter: Vorschaubild (4x4 Stichproben je 16x16-Feld, grösste Abweichung je Feld) mit dem zuletzt voll ausgewerteten Bild vergleichen.\n
+ *          Ohne geändertes Feld entfällt die Vorverarbeitung, das Mosaik und das Hintergrundmodell.
+ *          Verglichen wird mit dem letzten ausgewerteten Bild, nicht mit dem Vorgängerbild; langsame
+ *          Änderungen summieren sich also. Spätestens nach properties.skip_max Bildern bzw. SKIP_MAX_MS wird
+ *          voll ausgewertet.
+ *          Während einer Aufnahme (state != 0) und beim Aufwärmen wird nie übersprungen.
+ *          Übersprungene Bilder kommen nur alle SKIP_PREROLL_MS in den Pre-Roll (@ref control()); die Lücken füllt
+ *          @ref save_video beim Schreiben mit dem vorigen Bild.
+ * @param tv Aufnahme-Zeitpunkt des Bildes
+ * @return true: Bild übersprungen. @ref detect() muss nicht aufgerufen werden.
+ */
+bool MotionDetector::skip_frame (const struct timeval &tv)
+{
+    if (properties.skip_max == 0)
+        return false;
+
+    const int k = (properties.fast_pre) ? 2 : 1;
+    cv::Rect roi (geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1);
+    if (raw_fmt == PIXFMT_BGR)
+        preproc::thumb (src_image(roi), THUMB_BLOCK, ctx.thumb);
+    else if (raw_fmt == PIXFMT_YUYV)
+        preproc::thumb (ctx.yuyv(roi), THUMB_BLOCK, ctx.thumb);
+    else    // PIXFMT_MJPG: Graubild aus decode_raw(), im schnellen Pfad halbe Grösse
+        preproc::thumb (ctx.decoded(cv::Rect (roi.x / k, roi.y / k, roi.width / k, roi.height / k)), THUMB_BLOCK / k, ctx.thumb);
+
+    if (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0) {     // Ignor-Bereich zählt nicht
+        const int sp = THUMB_BLOCK / 4;                                 // Abstand der Stichproben im Kamerabild
+        cv::rectangle (ctx.thumb, 
+                       cv::Rect ((ignor_geo.ignorleft - roi.x) / sp, (ignor_geo.ignortop - roi.y) / sp, 
+                                 (ignor_geo.ignorwidth + sp - 1) / sp + 1, (ignor_geo.ignorheight + sp - 1) / sp + 1), 
+                       cv::Scalar (0),
+                       -1);
+    }
+
+    const long long t_ms = (long long)tv.tv_sec * 1000ll + tv.tv_usec / 1000;
+    const bool warm = (state == 0) && !in[last_in].empty() && bg.is_ready() && (roi.size() == ctx.roi);
+    if (warm && (skipped < properties.skip_max) && (t_ms - eval_ms < SKIP_MAX_MS) &&     // Fenster in Bildern und in [ms]
+        (ctx.thumb.size() == ctx.thumb_ref.size()) &&
+        (preproc::thumb_changed (ctx.thumb, ctx.thumb_ref, THUMB_THR) == 0)) {
+        ++skipped;
+        ++skip_total;
+        properties.diff_non_zero = 0;
+        now[first_in] = tv;         // Pre-Roll und CSV bekommen den Zeitstempel des aktuellen Bildes
+        return true;
+    }
+
+    skipped = 0;
+    eval_ms = t_ms;
+    std::swap (ctx.thumb, ctx.thumb_ref);   // dieses Bild wird ausgewertet und ist die neue Referenz
+    return false;
+}
+
+/*! -------------------------------------------------
+ * @brief   Ein Bild von aussen einspeisen, z.B. aus einem Benchmark. Es wird nicht gewartet.
+ * @param img BGR-Bild. Wird nach @ref src_image kopiert.
+ * @param tv Aufnahme-Zeitpunkt
+ */
+void MotionDetector::feed (const cv::Mat &img, const struct timeval &tv)
+{
+    properties.falle_aktiv = false;
+
+    img.copyTo (src_image);
+    raw_fmt = PIXFMT_BGR;
+    src_valid = true;
+    detect (tv);
+}
+
+/*! -------------------------------------------------
+ * @brief   Bewegungserkennung für das Bild in @ref src_image.
+ *
+ * Die Bewegungserkennung arbeitet mit <absdiff()> \n
+ * Sobald eine Bewegung erkannt wird, wechselt @ref <properties.falle_aktiv> auf true. \n
+ * <properties.falle_aktiv> wird in @ref control() ausgewertet. \n
+ * Mit <properties.fast_pre> ersetzt @ref preproc::gray_half() cvtColor() und das 1. pyrDown();
+ * Glätten, dilate und erode laufen dann auf der halben Auflösung.
+ * @param tv Aufnahme-Zeitpunkt von @ref src_image
+ */
+void MotionDetector::detect (const struct timeval &tv)
+{
+    first_in = (first_in < MAX_IN-1) ? first_in+1 : 0;  // Ringzähler weiterschieben
+    last_in = (last_in < MAX_IN-1) ? last_in+1 : 0;
+
+    cv::Rect roi (geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1);
+    if ((roi.size() != ctx.roi) || (properties.fast_pre != ctx.fast))
+        prepare_ctx (roi.size());
+
+    const int k = (properties.fast_pre) ? 2 : 1;    // schneller Pfad: Graubild und Filter in halber Auflösung
+    const bool ignor = (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0);
+    cv::Mat gray_in;                                    // Graubild des ROI, Eingang für den Stretch
+    if (raw_fmt == PIXFMT_BGR) {
+        cv::Mat src_roi;
+        if (ignor) {
+            src_image.copyTo (ctx.masked);
+            cv::rectangle (ctx.masked, 
+                           cv::Rect2d (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight), 
+                           cv::Scalar (0, 0, 0),
+                           -1);
+            cv::rectangle (src_image, 
+                           cv::Rect2d (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight), 
+                           cv::Scalar (0, 0, 255),
+                           2);
+            src_roi = ctx.masked(roi);
+        } else
+            src_roi = src_image(roi);                   // ohne Ignor-Bereich keine Kopie
+
+        if (properties.fast_pre)
+            preproc::gray_half (src_roi, ctx.gray);     // Graustufen und 1. Verkleinerung in einem Durchlauf
+        else
+            CVD::cvtColor (src_roi, ctx.gray, cv::COLOR_BGR2GRAY);  // Graustufenbild
+        gray_in = ctx.gray;
+    } else {
+        // ------ Rohdaten: nur die Helligkeit. Kein BGR-Bild. -------
+        if (raw_fmt == PIXFMT_YUYV) {
+            if (properties.fast_pre)
+                preproc::gray_half_yuyv (ctx.yuyv(roi), ctx.gray);
+            else
+                cv::extractChannel (ctx.yuyv(roi), ctx.gray, 0);    // Y
+            gray_in = ctx.gray;
+        } else      // PIXFMT_MJPG: schon in decode_raw() dekodiert
+            gray_in = ctx.decoded(cv::Rect (roi.x / k, roi.y / k, roi.width / k, roi.height / k));
+
+        if (ignor) {    // Ignor-Bereich im Graubild schwärzen. Koordinaten relativ zum ROI.
+            cv::rectangle (gray_in, 
+                           cv::Rect ((ignor_geo.ignorleft - roi.x) / k, (ignor_geo.ignortop - roi.y) / k, 
+                                     ignor_geo.ignorwidth / k, ignor_geo.ignorheight / k), 
+                           cv::Scalar (0),
+                           -1);
+        }
+    }
+    now[first_in] = tv;                                 // Aufnahme-Zeitpunkt vom Grabber übernehmen.
+
+    // ----------------- stretch gray image -------------------
+#ifdef SHOW_HISTOGRAM
+    cv::Mat hist = ctx.hist.getHistogram( gray_in );
+    if (!properties.no_output)
+        cv::imshow ("Hist", ctx.hist.getImageOfHistogram(hist, 1.0f));     // Ausgabe original Histogram
+#endif
+    ctx.hist.setLutCache( properties.lut_cache, LUT_STEP, LUT_TOLERANCE );
+    ctx.hist.stretch( gray_in, 0.0050f, ctx.stretched );           // Histogram wird gestretcht. LUT aus dem Cache.
+    cv::Mat &gray = ctx.stretched;
+
+#ifdef SHOW_HISTOGRAM
+    hist = ctx.hist.getHistogram( gray );
+    if (!properties.no_output)
+        cv::imshow ("Hist gestretcht", ctx.hist.getImageOfHistogram(hist, 1.0f));   // Ausgabe gestretchtes Histogram
+#endif
+    // --------- End of stretch gray image --------------------
+
+#ifdef USE_HARRIS_DETECTOR
+    // ---------------------- Harris Corner -----------------------
+    gray.copyTo (harrisCorners);
+    harris.detect(gray);                                // Compute Harris corners
+    std::vector<cv::Point> pts;
+    harris.getCorners(pts, 0.02);                       // ermittle Koordinaten
+    harris.drawOnImage(harrisCorners, pts, 255, 10, 2);  // Draw Harris corners
+    cv::resize (harrisCorners, harrisCorners, cv::Size(), 0.5, 0.5);    // Bild verkleinern
+
+    char buf[256];
+    sprintf (buf, "%ld", static_cast<long int>(pts.size()));
+    cv::putText(harrisCorners,                  // target image
+                buf,                            // text
+                cv::Point(10, 20),              // top-left position
+                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
+                1.0,                            // fontScale
+                255,                            // font color
+                2);                             // thickness
+#endif
+
+#ifdef USE_FEATURE_DETECTOR
+    gray.copyTo (harrisCorners);        // aktuelles Bild kopieren
+    // -------------------- detector -----------------------
+    pyrKeypoints.clear();
+    detector->detect(gray, pyrKeypoints);
+
+    std::vector<cv::Point> points;
+    std::vector<cv::KeyPoint>::iterator it;
+    for( it= pyrKeypoints.begin(); it!= pyrKeypoints.end(); it++)
+        points.push_back(it->pt);
+
+    harris.drawOnImage(harrisCorners, points, 255, 7, 1);  // Draw Harris corners
+    // std::cout << "Interest points: Mat gray=" << pyrKeypoints.size() << std::endl;
+#endif
+
+    // ---------------------- smooth ------------------------
+    cv::boxFilter (gray, ctx.a, -1, cv::Size(6 / k, 6 / k));   // glätten: blur, gaussianBlur, filter2D, medianBlur, bilateralFilter, ...
+
+    /* // ------------------- Versuch -----------------
+    cv::Mat dummy;
+    CVD::Laplacian (gray, dummy, CV_64F, 1, 1, 0);
+    CVD::Sobel (dummy, dummy, CV_64F, 1, 1, 5);
+    CVD::convertScaleAbs( dummy, gray );           // converting back to CV_8U
+    */
+
+    // ------------ closing: dilate und erode mit 13 x 13 (schneller Pfad: 7 x 7) -------------
+    cv::Mat &closed = (properties.fast_pre) ? seg_in[first_in] : ctx.a;    // schneller Pfad: hat schon die halbe Grösse
+    if (properties.morph == MORPH_VHGW) {
+        morph::dilate (ctx.a, ctx.b, 6 / k);            // O(1) je Pixel, Ergebnis wie cv::dilate()
+        morph::erode (ctx.b, closed, 6 / k);
+    } else {
+        cv::dilate(ctx.a, ctx.b, Mat(), Point(-1, -1), 6 / k, 1, 1);
+        cv::erode(ctx.b, closed, Mat(), Point(-1, -1), 6 / k, 1, 1);
+    }
+    if (!properties.fast_pre)
+        cv::pyrDown (ctx.a, seg_in[first_in], cv::Size(0, 0));     // direkt in den Ringpuffer des Mosaiks
+    make_seg (seg_in[first_in]);
+    cv::pyrDown (seg_in[first_in], in[first_in], cv::Size(0, 0));   // in[first_in] enthält das runter gebrochene Bild !!!
+
+    // Differenz zum Vorgängerbild und Hintergrundmodell in einem Durchlauf über in[first_in].
+    // Das Differenzbild <diff> wird nur für die Bildschirmausgabe geschrieben.
+    bg.set_mode (properties.bg_mode);
+    const bool prev = !in[last_in].empty();
+    int nz = bg.update (in[first_in], (prev) ? &in[last_in] : NULL, (uint8_t)properties.threshold,
+                        (properties.no_output) ? NULL : &diff);
+    if (prev) {
+        anz_zero[first_in] = nz;
+        properties.diff_non_zero = anz_zero[last_in] - anz_zero[first_in];  // Differenz zum Vorgängerbild berechnen.
+        if (abs(properties.diff_non_zero) >= properties.video_start_diff) { // Hat es eine groessere Differenz ergeben ?
+            properties.falle_aktiv = true;      // Bewegung erkannt. Video kann gestartet werden.
+        }
+    }
+
+#ifndef NDEBUG
+    check_ctx ();
+#endif
+}
+
+/*! -------------------------------------------------
+ * @brief   Mittelwert des Hintergrundmodells als Graubild für die Bildschirmausgabe.
+ * @return  leer, solange das Modell nicht eingeschwungen ist
+ */
+cv::Mat &MotionDetector::get_back ()
+{
+    if (bg.is_ready())
+        bg.get_mean (back);
+    else
+        back.release ();
+    return back;
+}
+
+/*! -------------------------------------------------
+ * @brief   Puffer von @ref ctx für eine neue ROI-Grösse anlegen.\n
+ *          Die Ringpuffer @ref in[] und @ref seg_in[] werden verworfen, da die alten Bilder nicht mehr passen.
+ *          Sie werden in den folgenden MAX_IN Bildern von pyrDown() neu angelegt.
+ * @param roi Grösse des sensitiven Bildausschnitts
+ */
+void MotionDetector::prepare_ctx (cv::Size roi)
+{
+    ctx.roi = roi;
+    ctx.fast = properties.fast_pre;
+    cv::Size size = (ctx.fast) ? cv::Size (roi.width / 2, roi.height / 2) : roi;   // Grösse des Graubilds
+    ctx.gray.create (size, CV_8UC1);
+    ctx.stretched.create (size, CV_8UC1);
+    ctx.a.create (size, CV_8UC1);
+    ctx.b.create (size, CV_8UC1);
+    for (int i=0; i<MAX_IN; i++) {
+        in[i].release ();
+        seg_in[i].release ();
+    }
+    bg.reset ();
+    ctx.warm = 0;
+}
+
+/*! -------------------------------------------------
+ * @brief   Debug: prüft, ob ein Puffer der Pipeline nach dem Aufwärmen neu angelegt wurde.\n
+ *          Ein geänderter Datenzeiger heisst: Allokation im Dauerbetrieb. Gezählt wird in ctx.allocs.
+ */
+void MotionDetector::check_ctx ()
+{
+    const uchar *data[FRAME_CTX_BUFS] = {ctx.masked.data, ctx.gray.data, ctx.stretched.data, ctx.a.data, ctx.b.data,
+                                         diff.data, seg_NonZero.data, ctx.decoded.data};
+    for (int i=0; i<MAX_IN; i++) {
+        data[8 + i] = in[i].data;
+        data[8 + MAX_IN + i] = seg_in[i].data;
+    }
+
+    int n = 0;
+    for (int i=0; i<FRAME_CTX_BUFS; i++) {
+        if (data[i] != ctx.data[i])
+            ++n;
+        ctx.data[i] = data[i];
+    }
+
+    if (ctx.warm < MAX_IN) {        // erst alle Ringpuffer einmal belegen
+        ++ctx.warm;
+        return;
+    }
+    if (n > 0) {
+        ctx.allocs += n;
+        cout << "WARNING frame_ctx: " << n << " Puffer neu angelegt" << endl;
+    }
+}
+
+/*! -------------------------------------------------
+ * @brief   Rohdaten aus dem @ref grabber für @ref detect() vorbereiten.\n
+ *          YUYV bekommt nur einen CV_8UC2-Header, MJPEG wird nur als Graubild dekodiert.
+ * @return false: Bild ist defekt oder passt nicht zur Bildgrösse. Es wird nicht ausgewertet.
+ */
+bool MotionDetector::decode_raw ()
+{
+    if (raw_fmt == PIXFMT_YUYV) {
+        if (raw.total() * raw.elemSize() != (size_t)frame_w * frame_h * 2) {
+            cout << "ERROR YUYV: " << raw.total() * raw.elemSize() << " Bytes passen nicht zu " << frame_w << "x" << frame_h << endl;
+            return false;
+        }
+        ctx.yuyv = raw.reshape (2, frame_h);        // keine Kopie
+    } else if (raw_fmt == PIXFMT_MJPG) {
+        const int k = (properties.fast_pre) ? 2 : 1;
+        cv::imdecode (raw, (k == 2) ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_GRAYSCALE, &ctx.decoded);
+        if ((ctx.decoded.cols < frame_w / k) || (ctx.decoded.rows < frame_h / k)) {
+            cout << "ERROR MJPEG: Bild kann nicht dekodiert werden\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*! -------------------------------------------------
+ * @brief   Kamerabild als BGR. Bei Rohdaten (--pixfmt yuyv | mjpg) wird erst hier gewandelt,
+ *          also nur für Bilder, die angezeigt oder gespeichert werden.
+ */
+cv::Mat &MotionDetector::get_src_image ()
+{
+    if (!src_valid) {
+        if (raw_fmt == PIXFMT_YUYV)
+            cv::cvtColor (ctx.yuyv, src_image, cv::COLOR_YUV2BGR_YUYV);
+        else
+            cv::imdecode (raw, cv::IMREAD_COLOR, &src_image);
+
+        if (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0) {
+            cv::rectangle (src_image, 
+                           cv::Rect2d (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight), 
+                           cv::Scalar (0, 0, 255),
+                           2);
+        }
+        src_valid = true;
+    }
+    return src_image;
+}
+
+/*! -------------------------------------------------
+ * @brief Dauer des Nachlaufs in [ms]: properties.trail Bilder bei properties.fps.\n
+ *        Gemessen wird mit den Zeitstempeln der Bilder. Wie viele Bilder es tatsächlich werden, hängt von der Last ab.
+ */
+int MotionDetector::trail_time ()
+{
+    return properties.trail * 1000 / properties.fps;
+}
+
+/*! -------------------------------------------------
+ * @brief Laufzeit des aktuellen Videos in [ms].\n
+ *        Es zählen die Zeitstempel der Bilder, nicht die Uhr. Im Replay-Modus also die Video-Zeit.
+ */
+int MotionDetector::rec_time ()
+{
+    return timefunc::difference_milli (&rec_start, &now[first_in]);
+}
+
+/*! -------------------------------------------------
+ * @brief Eine laufende Aufnahme beenden. Wird am Ende des Replay-Modus aufgerufen,
+ *        wenn keine Bilder mehr für den Nachlauf kommen.
+ */
+void MotionDetector::finish ()
+{
+    if ((state == 110) || (state == 120) || (state == 130)) {
+        sv.close();
+        cout << endl;
+        frame_counter = 0;
+    }
+    state = 0;
+}
+
+/*! -------------------------------------------------
+ * @brief CSV-Protokoll öffnen. Für jedes Bild wird in @ref control() eine Zeile geschrieben.\n
+ *        Spalten: Bild-Nr.; Zeit in [ms]; diff_non_zero; aktive Mosaik-Felder; Belegung in [%]; state; Zustandswechsel
+ * @param fname Dateiname
+ * @return true: Datei ist geöffnet.
+ */
+bool MotionDetector::open_csv (const std::string &fname)
+{
+    csv.open (fname.c_str(), std::ios::out | std::ios::trunc);
+    if (!csv.is_open())
+        return false;
+
+    csv_frame = 0;
+    csv << "frame;time_ms;diff_non_zero;seg_active;seg_occupancy;state;transition\n";
+    return true;
+}
+
+/*! -------------------------------------------------
+ * @brief CSV-Protokoll schliessen.
+ */
+void MotionDetector::close_csv ()
+{
+    if (csv.is_open())
+        csv.close();
+}
+
+/*! -------------------------------------------------
+ * @brief Eine Zeile ins CSV-Protokoll schreiben.
+ * @param old_state state vor dem Durchlauf von @ref control()
+ */
+void MotionDetector::write_csv (uint16_t old_state)
+{
+    if (csv_frame == 0)
+        csv_start = now[first_in];
+
+    int ms = timefunc::difference_milli (&csv_start, &now[first_in]);
+    int active = cv::countNonZero (seg_NonZero);
+
+    csv << csv_frame++ << ';' << ms << ';' << properties.diff_non_zero << ';' 
+        << active << ';' << (active * 100) / (properties.grid_x * properties.grid_y) << ';' << state << ';';
+    if (old_state != state)
+        csv << old_state << "->" << state;
+    csv << '\n';
+}
+
+/*! -------------------------------------------------
+ * @brief state-machine kontrolliert den Videostream.
+ *
+ * Im wesentlichen werden Frameänderung und Framespeicherung abgearbeitet. \n
+ * Im Idle-Mode werden Frameänderungen erkannt aber nicht gespeichert. \n
+ * Gesteuert wird die state-machine durch die Variable @ref state.
+ * @return false: es lag kein neues Bild vor. Die state-machine wurde nicht durchlaufen.
+ */
+bool MotionDetector::control()
+{
+    char fname[512];
+    const uint16_t old_state = state;
+
+    if (!get_frame())   // Bildeinzug und Bewegungserkennung. Wenn eine Bewegung erkannt wurde, wird <falle_aktiv> TRUE
+        return false;
+
+    switch (state) {
+        case 0: // --------------- idle - state ------------------
+            if (!properties.run) {      // ---- Überwachung ist NICHT inaktiv ----
+                if (properties.falle_aktiv) {
+                    if (!properties.no_output) cout << " Bewegung erkannt(" << bewegung_counter << "): " << properties.diff_non_zero << endl;     // Anzeigen, das die Falle eine Bewegung erkannt hat !!!
+                    ++bewegung_counter;
+                    properties.falle_aktiv = false;
+                    properties.diff_non_zero = 0;
+                }
+                break;
+            } else {                    // ---- Überwachung ist aktiv ----
+                const long long t_ms = (long long)now[first_in].tv_sec * 1000ll + now[first_in].tv_usec / 1000;
+                if (!properties.only_picture &&                     // Pre-Roll: Bild für den Anfang des nächsten Videos puffern.
+                    ((skipped == 0) || (t_ms - preroll_last_ms >= SKIP_PREROLL_MS))) {  // übersprungen: unverändert, das Raster wiederholt das vorige
+                    preroll_last_ms = t_ms;
+                    char buf[256];
+                    record_text (buf, sizeof(buf));
+                    sv.buffer (record_image(), &now[first_in], buf);
+                }
+
+                if (properties.falle_aktiv) {       // Falle ist aktiviert. Siehe <get_frame()>. 
+                    if (!properties.no_output) cout << "now: " << properties.diff_non_zero << endl;
+
+                    // Bestätigung durch das Hintergrundmodell: nur Vordergrund-Pixel zählen.
+                    // Flackern und Rauschen, das zum Hintergrund zurückkehrt, startet keine Aufnahme.
+                    const int schwelle = properties.video_start_diff;
+                    int delta = schwelle + 1;   // Modell noch nicht eingeschwungen: Bewegung gilt
+
+                    if (bg.is_ready()) {
+                        delta = bg.get_fg_count();
+                        if (!properties.no_output) cout << "foreground " << delta << endl;
+                    }
+
+                    if (delta >= schwelle) { 
+                        nachlauf_counter = 0;
+                        state = 100;        // Aufnahme starten
+                    } else {
+                        properties.falle_aktiv = false;
+                        properties.diff_non_zero = 0;
+                    }
+                } else { 
+                    if (abs(properties.diff_non_zero) > 0) {         // noch keine aktive Falle aber es sind Differenz-Pixel vorhanden
+                        if (!properties.no_output) cout << properties.diff_non_zero << endl;
+                    }
+                }
+            }
+            break;
+        case 100: {
+                // --------------- Dateiname berechnen ------------------
+                if (!properties.only_picture)                               // video Mode
+                    sprintf (fname, "%s/out%i.%s", folder.c_str(), vid_counter, sv.get_ext());   // Dateiname ermitteln
+                else {                                              // only picture Mode
+                    sprintf (fname, "%s/out_picture.%s", folder.c_str(), sv.get_ext());  // Frame Dateiname ermitteln
+                    sprintf (pic_name, "%s/out%i.jpg", folder.c_str(), vid_counter);    // Picture Dateiname
+                }
+
+                ++vid_counter;
+
+                // ---------------- Video-Datei öffnen ----------------
+                // cv::Mat foo = make_ausgabe_screen(src[last_in], show_seg);  // Bildgroesse ermitteln
+                cv::Mat foo = record_image();       // Bildgroesse ermitteln
+
+                bool ret = sv.open ( fname, foo.cols, foo.rows, properties.fps );   // Datei mit entsprechender Bildgroesse oeffnen !
+                if (!ret)
+                    cout << "cant open " << fname << endl;
+
+                frame_counter = 0;
+                state = 110;
+                rec_start = now[first_in];          // je Instanz, kein globaler Timer (mehrere Kameras)
+            }
+            break;
+        case 110: {
+                // ---------------- Bilder speichern -------------------
+                char buf[256];
+                record_text (buf, sizeof(buf));
+
+                sv.write( record_image(),  &now[first_in], buf );     // Bild im Video ablegen !!!
+                cout << "." << flush;       // Fortschrittsanzeige
+                ++frame_counter;
+
+                if (properties.only_picture) {      // Bilder speichern
+                    if (frame_counter == 3) {
+                        // -------- Support for writing JPG ----------
+                        vector<int> compression_params;
+                        compression_params.push_back( cv::IMWRITE_JPEG_QUALITY );
+                        compression_params.push_back( 100 );
+                        // cv::Mat out (src[last_in]);
+                        cv::Mat out (get_src_image());
+                        if (sv.get_gray_flag() == true)
+                            cv::cvtColor (out, out, cv::COLOR_BGR2GRAY);               // Graustufenbild
+
+                        sv.write_date_to_pic (out, &now[first_in].tv_sec, buf);     // Zeit ins Bild schreiben
+                        cv::imwrite (pic_name, out, compression_params);    // save image
+                        if (sv.get_storage() != NULL)
+                            sv.get_storage()->add (pic_name, "picture");
+                    }
+                }
+
+                if (properties.falle_aktiv) {
+                    if (rec_time() >= properties.max_time) {    // max.Anzahl Bilder erreicht. 
+                                                                                    // Goto close Viedeo. 
+                                                                                    // Es findet kein Nachlauf statt !!!
+                        state = 130;                // Goto close Video
+                    }
+                } else if (rec_time() > properties.min_time - trail_time()) {     // Es ist keine Bewegung erkannt worden und 
+                                                    // das Video erreicht mit dem Nachlauf die min. Länge.
+                    nachlauf_counter = 0;
+                    trail_start = now[first_in];
+                    state = 120;                    // Goto Video Nachlauf
+                }
+            }
+            break;
+        case 120: {  // ------------ video Nachlauf: trail Bilder bei --fps ----------------------
+                char buf[256];
+                record_text (buf, sizeof(buf));
+
+                sv.write ( record_image(),  &now[first_in], buf );     // Bild im Video ablegen !!!
+                cout << "." << flush;       // Fortschrittsanzeige
+                ++frame_counter;
+                ++nachlauf_counter;
+
+                if ((timefunc::difference_milli (&trail_start, &now[first_in]) >= trail_time()) || (rec_time() > properties.max_time)) 
+                    state = 130;        // close video
+            }
+            break;
+        case 130:   // ------------------ close video --------------------------
+            sv.close();
+            cout << endl;
+            // cout << "Aufnahmedauer = " << timefunc::stop_timer("CONTROL") << " ms" << endl;
+            frame_counter = 0;
+            state = 0;
+            break;
+    }
+
+    if (csv.is_open())
+        write_csv (old_state);
+    return true;
+}
+
+
+//! @} MotionDetector
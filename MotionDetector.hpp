@@ -0,0 +1,295 @@
+/*! ------------------------------------------
+ * @defgroup MotionDetector MotionDetector: Bewegungserkennung
+ * @{
+ *
+ * @file    MotionDetector.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Class für die Bewegungserkennung.\n
+ * Enthält die Pipeline aus @ref MotionDetector::get_frame(), @ref MotionDetector::make_seg()
+ * und die state-machine @ref MotionDetector::control(). \n
+ * Die Klasse ist Bestandteil der Bibliothek liblookat.a. Das Programm lookat verwaltet nur noch
+ * Optionen, Tastatur und Bildschirmausgabe.
+ *
+ * @copyright Copyright (c) 2021, 2022, 2023, 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef MOTIONDETECTOR_HPP
+#define MOTIONDETECTOR_HPP
+
+// -------- define for developer -------
+#define USE_HARRIS_DETECTOR_        //!< Versuch: Über die Anzahl der Punkte eine Bewegung erkennen.
+#define USE_FEATURE_DETECTOR_
+
+#ifdef USE_FEATURE_DETECTOR
+    #define USE_HARRIS_DETECTOR
+#endif
+
+#define SHOW_MOSAIK_                //!< SHOW_MOSAIK zeigt ein screen mit dem Mosiak.
+#define SHOW_HISTOGRAM_             //!< SHOW_HISTOGRAM zeigt das original und gestretchte Histogram.
+// -------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include "opencv2/opencv.hpp"
+
+#include "Frame_Grabber.hpp"
+#include "Save_Vid.hpp"
+#include "tile_blobs.hpp"
+#include "morph.hpp"
+#include "histogram.h"
+#include "bg_model.hpp"
+#ifdef USE_HARRIS_DETECTOR
+    #include "harrisDetector.h"
+#endif
+
+#define MAX_IN 3                //!< Anzahl matrices für den Verlauf der Graubilder. @ref MotionDetector::in[], @ref MotionDetector::seg_in[]
+#define HORZ_TEILER 8           //!< Default für die horizontale Auflösung des Mosaiks. Option --grid
+#define VERT_TEILER 6           //!< Default für die vertikale Auflösung des Mosaiks. Option --grid
+#define MAX_TEILER 64           //!< Max. Anzahl Felder je Richtung für --grid
+#define FPS_DEFAULT 10          //!< Default: Ziel-Framerate der Auswertung. Option --fps
+#define IDLE_FPS 2              //!< Default: Framerate bei ruhigem Bild. Option --idlefps
+#define TILE_THREADS 1          //!< Default: Mosaik-Felder seriell zählen. Option --threads
+#define SKIP_MAX 10             //!< Default: Vorfilter überspringt höchstens 10 Bilder in Folge. 0 = Vorfilter aus. Option --skip
+#define THUMB_BLOCK 16          //!< Vorfilter: Vorschaubild in 1/16 der ROI-Grösse
+#define THUMB_THR 16            //!< Vorfilter: ein Feld gilt als geändert, wenn eine Stichprobe um mehr als 16 Graustufen abweicht
+#define SKIP_MAX_MS 1000        //!< Vorfilter: spätestens nach 1000 ms wird voll ausgewertet, unabhängig von --skip und --idlefps
+#define SKIP_PREROLL_MS 1000    //!< Vorfilter: übersprungene Bilder höchstens alle 1000 ms in den Pre-Roll (Lücke < SV_MAX_GAP)
+#define RECORD_COMPOSITE 0      //!< Video: Kamerabild und Contour-Bild nebeneinander, Text im Bild. Option --record composite
+#define RECORD_RAW 1            //!< Video: nur das Kamerabild, Text als Untertitel (.vtt). Option --record raw
+#define IDLE_TIME 5000          //!< Ruhiges Bild: nach 5000 ms ohne Differenz-Pixel auf --idlefps wechseln
+#define CONTOUR_W 320           //!< Max. Breite des Contour-Bildes in Pixeln, unabhängig von --grid. @ref MotionDetector::contour_scale()
+#define CONTOUR_H 240           //!< Max. Höhe des Contour-Bildes in Pixeln
+#define LUT_CACHE 10            //!< Default: Stretch-LUT spätestens alle 10 Bilder neu berechnen. Option --lutcache
+#define LUT_STEP 4              //!< LUT-Cache: Histogramm aus jeder 4. Zeile und Spalte
+#define LUT_TOLERANCE 2.0f      //!< LUT-Cache: neue LUT, wenn die mittlere Helligkeit um mehr als 2 Graustufen abweicht
+
+#pragma pack(1)
+
+/*! ---------------------------------------------------------------
+ * @brief Diverse Parameter
+ */
+struct _properties_ {
+    int cam_index = 0;          //!< Kann mit Parameter --cam geändert werden.
+    int threshold = 64;         //!< Alle Pixel in diff unter 64 werden auf 0 gesetzt. @see @ref schwelle()
+    int diff_non_zero = 0;      //!< Enthält die aktuelle NonZero Differenz von last_in - first_in.
+    int video_start_diff = 5;   //!< sobald @ref diff_non_zero >= video_start_diff ist, wird eine Aufnahme gestartet! Wertebereich: [1...5000]. See: @ref MotionDetector::control(). Das Flag @ref falle_aktiv wird auf TRUE gesetzt!
+    bool falle_aktiv = false;   //!< Flag zeigt an, ob eine Bewegung erkannt wurde. @ref MotionDetector::get_frame().
+    int trail = 7;              //!< Nachlauf in frames bei @ref fps, z.B. 700 ms bei 10 fps. @see @ref MotionDetector::trail_time()
+    bool run = true;            //!< Überwachung aktiv / inaktiv
+    bool no_output = false;     //!< bei true wird kein Camerabild gezeigt. Wird mit der Option --noutput gesetzt.
+    int frame_delay = 1000000 / FPS_DEFAULT;    //!< Aktuelle Periode in [us]. Wird in @ref MotionDetector::pace() aus fps bzw. idle_fps berechnet.
+    int fps = FPS_DEFAULT;      //!< Ziel-Framerate der Auswertung. Option --fps
+    int idle_fps = IDLE_FPS;    //!< Framerate bei ruhigem Bild. 0 = aus. Option --idlefps
+    int NonZero_seg = 25;       //!< pixdiff für Mosaik. Lässt sich mit der Option --pixdiff ändern.
+    int min_time = 2700;        //!< Min.Videolänge in [ms]. Kleinster zulässiger Wert ist 2000 ms
+    int max_time = 20000;       //!< Max.Videolänge in [ms].
+    bool only_picture = false;  //!< Bei true werden nur Bilder gespeichert, kein Videos. Wird mit der Option --picture eingeschaltet.
+    std::string vidpath;        //!< Pfad zum Sichern der Bewegungs-Videos; default: ~/lookat_video/DATUM
+    int vid_queue = SV_QUEUE_DEPTH;     //!< Tiefe der Video-Warteschlange. 0 = synchron. Option --vidqueue
+    int vid_policy = SV_DROP;           //!< Verhalten bei voller Video-Warteschlange. Option --vidpolicy
+    int preroll = SV_PREROLL_TIME;      //!< Pre-Roll in [ms]. 0 = aus. Option --preroll
+    int preroll_mem = SV_PREROLL_MEM;   //!< Max. Speicher für den Pre-Roll in [kB]. Option --prerollmem
+    int grid_x = HORZ_TEILER;           //!< Mosaik: Anzahl Felder horizontal. Option --grid WxH
+    int grid_y = VERT_TEILER;           //!< Mosaik: Anzahl Felder vertikal. Option --grid WxH
+    int lut_cache = LUT_CACHE;          //!< Stretch-LUT nur alle lut_cache Bilder neu berechnen. 0 = jedes Bild. Option --lutcache
+    int morph = MORPH_VHGW;             //!< dilate/erode: MORPH_VHGW oder MORPH_OPENCV. Option --morph
+    int threads = TILE_THREADS;         //!< Mosaik-Felder in Bändern parallel zählen. 1 = seriell, 0 = alle Threads von OpenCV. Option --threads (setzt beim Start cv::setNumThreads())
+    int skip_max = SKIP_MAX;            //!< Vorfilter: max. Anzahl übersprungener Bilder in Folge. 0 = jedes Bild voll auswerten. Option --skip
+    int record = RECORD_COMPOSITE;      //!< Inhalt des Videos: RECORD_COMPOSITE oder RECORD_RAW. Option --record
+    int bg_mode = BG_GAUSS;             //!< Hintergrundmodell: BG_MEAN oder BG_GAUSS. Option --bgmodel
+    bool fast_pre = false;              //!< Schnelle Vorverarbeitung: Grau, ROI und 1. Verkleinerung in einem Durchlauf. Option --fastpre
+    bool replay = false;                //!< Bilder kommen aus einer Datei. Kein Warten in @ref MotionDetector::pace(). Option --input
+};
+
+/*! ----------------------------------------------------------------------
+ * @brief Sensitiver Bildausschnitt
+ */
+struct _geo_ {
+    int left = 0;
+    int top = 0;
+    int right = 639;        //!< if (cam_para.fwidth > geo.width) geo.width = cam_para.fwidth;
+    int bottom = 479;       //!< if (cam_para.fheight > geo.height) geo.height = cam_para.fheight;
+};
+
+/*! ----------------------------------------------------------------------
+ * @brief Ignorierter Bildausschnitt
+ */
+struct _ignor_geo_ {
+    int ignorleft = 0;
+    int ignortop = 0;
+    int ignorwidth = 0;
+    int ignorheight = 0;
+};
+
+#pragma pack()
+
+#define FRAME_CTX_BUFS (6 + 2*MAX_IN + 2)  //!< Anzahl überwachter Puffer in @ref MotionDetector::check_ctx()
+
+/*! ----------------------------------------------------------------------
+ * @brief Puffer für @ref MotionDetector::detect().\n
+ *        Werden beim ersten Bild und bei geändertem ROI angelegt und danach nur noch überschrieben.
+ */
+struct _frame_ctx_ {
+    cv::Size roi;               //!< ROI-Grösse, für die die Puffer angelegt sind
+    bool fast = false;          //!< Puffer für den schnellen Pfad (halbe Grösse). @ref _properties_::fast_pre
+    cv::Mat masked;             //!< Kopie von src_image. Nur bei Ignor-Bereich.
+    cv::Mat gray;               //!< Graubild des ROI. Im schnellen Pfad halbe Grösse.
+    cv::Mat yuyv;               //!< --pixfmt yuyv: Rohdaten als CV_8UC2. Nur ein Header auf @ref MotionDetector::raw.
+    cv::Mat decoded;            //!< --pixfmt mjpg: nur die Helligkeit dekodiert (schneller Pfad: halbe Grösse)
+    cv::Mat thumb;              //!< Vorfilter: Vorschaubild des aktuellen Bildes. @ref MotionDetector::skip_frame()
+    cv::Mat thumb_ref;          //!< Vorfilter: Vorschaubild des zuletzt voll ausgewerteten Bildes
+    cv::Mat stretched;          //!< Graubild nach dem Histogram-Stretch
+    cv::Mat a, b;               //!< Wechselpuffer für boxFilter(), dilate(), erode()
+    Histogram1D hist;           //!< Histogramm und LUT für den Stretch
+    int warm = 0;               //!< Bilder seit dem Anlegen. Nach MAX_IN Bildern sind alle Ringpuffer belegt.
+    uint64_t allocs = 0;        //!< Debug: Puffer, die nach dem Aufwärmen neu angelegt wurden
+    const uchar *data[FRAME_CTX_BUFS] = {NULL};     //!< Debug: Pufferadressen des letzten Bildes
+};
+
+/*! -------------------------------
+ * @brief class für die Bewegungserkennung.\n
+ *        Die Bilder kommen aus einem @ref frame_grabber. Siehe @ref set_source().
+ */
+class MotionDetector {
+public:
+    MotionDetector ();
+    ~MotionDetector () {}
+
+    MotionDetector (MotionDetector&) = delete;
+    void operator= (MotionDetector&) = delete;
+
+    void set_source (frame_grabber *g) { grabber = g; }
+    void set_pooled (bool on) { pooled = on; }          // true: get_frame() wartet nicht, Takt über get_due()
+    long long get_due ();
+    void reset_geo (const struct _geo_ &wish, int fwidth, int fheight);
+    void init_vid_counter ();
+
+    bool get_frame ();
+    void feed (const cv::Mat &img, const struct timeval &tv);
+    bool control ();
+    void finish ();
+
+    bool open_csv (const std::string &fname);
+    void close_csv ();
+
+    int check_pixdiff ();
+    int get_anzahl_sensetive_pixel ();
+    cv::Mat make_ausgabe_screen (cv::Mat src, cv::Mat seg_screen);
+    cv::Mat record_image ();
+    void record_text (char *buf, size_t n);
+    void write_diff_non_zero_to_diff ();
+
+    // -------- Bilder für die Bildschirmausgabe --------
+    cv::Mat &get_src_image ();
+    cv::Mat &get_diff () { return diff; }     // bei properties.no_output leer
+    bool is_ready () { return !in[last_in].empty(); }   // genug Bilder für das Differenzbild
+    cv::Mat &get_back ();                             // Mittelwert des Hintergrundmodells
+    const cv::Mat &get_fg () { return bg.get_fg(); }  // Vordergrund-Maske, Auflösung wie in[]
+    cv::Mat &get_contours_pic ();
+    float contour_scale ();
+    const std::vector<struct _blob_> &get_blobs () { return blobs; }
+    uint64_t get_ctx_allocs () { return ctx.allocs; }  // nur in Debug-Builds gezählt
+    bool is_idle () { return idle; }                   // Auswertung mit --idlefps
+    uint64_t get_skipped () { return skip_total; }      // vom Vorfilter übersprungene Bilder
+#ifdef SHOW_MOSAIK
+    cv::Mat &get_show_seg () { return show_seg; }
+#endif
+#ifdef USE_HARRIS_DETECTOR
+    cv::Mat &get_harris_corners () { return harrisCorners; }
+#endif
+
+    struct _properties_ properties;     //!< Diverse Parameter
+    struct _geo_ geo;                   //!< Sensitiver Bildausschnitt. @see @ref reset_geo()
+    struct _ignor_geo_ ignor_geo;       //!< Ignorierter Bildausschnitt
+    save_video sv;                      //!< class {@ref Save_Vid.hpp}
+    std::string folder;                 //!< Ausgabeverzeichnis; default: ~/lookat_video/DATUM
+    int vid_counter = 0;                //!< Nr. des nächsten Videos. @see @ref init_vid_counter()
+    int anz_sensetive_pixel = 0;        //!< Anzahl der senetiven Pixel. Wird berechnet in @ref get_anzahl_sensetive_pixel()
+
+private:
+    friend class md_bench;              // Laufzeitmessung der einzelnen Stufen. @see bench.cpp
+
+    void detect (const struct timeval &tv);
+    bool skip_frame (const struct timeval &tv);
+    void prepare_ctx (cv::Size roi);
+    void check_ctx ();
+    bool decode_raw ();
+    void pace ();
+    void make_seg (cv::Mat basis);
+    void label_blobs ();
+    int rec_time ();
+    int trail_time ();
+    void write_csv (uint16_t old_state);
+
+    frame_grabber *grabber = NULL;      //!< Bildquelle
+
+    cv::Mat in[MAX_IN];                 //!< gray Image Ringpuffer. Das Kamerabild selbst kommt aus dem Ring von @ref grabber.
+    cv::Mat src_image;                  //!< Input Image (BGR). Bei Rohdaten erst in @ref get_src_image() gewandelt.
+    cv::Mat raw;                        //!< Rohdaten (YUYV, MJPEG) des neuesten Bildes aus @ref grabber
+    int raw_fmt = PIXFMT_BGR;           //!< Format des aktuellen Bildes. @see @ref frame_grabber::set_pixfmt()
+    bool src_valid = true;              //!< false: @ref src_image muss noch aus @ref raw gewandelt werden.
+    int frame_w = 0, frame_h = 0;       //!< Bildgrösse der Kamera. @see @ref reset_geo()
+    struct _frame_ctx_ ctx;             //!< wiederverwendete Puffer der Pipeline
+
+    // ------------- Takt der Auswertung. @see pace() -------------
+    long long tick_us = 0;              //!< CLOCK_MONOTONIC: Start der letzten Periode in [us]. 0 = noch kein Bild
+    long long active_us = 0;            //!< CLOCK_MONOTONIC: letztes Bild mit Differenz-Pixeln in [us]
+    bool idle = false;                  //!< true: ruhiges Bild, Auswertung mit properties.idle_fps
+    int skipped = 0;                    //!< Vorfilter: übersprungene Bilder in Folge
+    long long eval_ms = 0;              //!< Vorfilter: Zeitstempel des zuletzt voll ausgewerteten Bildes in [ms]
+    long long preroll_last_ms = 0;      //!< Zeitstempel des letzten Pre-Roll Bildes in [ms]. @see control()
+    uint64_t skip_total = 0;            //!< Vorfilter: übersprungene Bilder gesamt
+    bool pooled = false;                //!< true: mehrere Kameras, der worker_pool ruft zum Termin aus @ref get_due() auf
+
+    cv::Mat seg_in[MAX_IN];             //!< Eingang für das Mosaik (Graubild nach dem 1. pyrDown)
+    int seg_w = 0, seg_h = 0;           //!< kleinste Grösse eines Mosaik-Feldes, z.B.:  640 x 480 => 40 x 40
+    std::vector<int> seg_xe, seg_ye;    //!< Feldgrenzen in seg_in. @see @ref pixdiff::tile_edges()
+    std::vector<int> seg_count;         //!< Differenzpixel je Feld, zeilenweise (grid_y x grid_x)
+    cv::Mat seg_NonZero;                //!< Mosaik-Matrix (grid_y x grid_x)
+    std::vector<struct _blob_> blobs;   //!< Bewegungsflächen im Mosaik. @see @ref label_blobs()
+    cv::Mat contours_pic;               //!< Contour-Bild. Wird erst in @ref get_contours_pic() gezeichnet.
+    bool contours_valid = false;        //!< false: @ref contours_pic muss neu gezeichnet werden.
+    int contour_x_center = 0;           //!< Konturschwerpunkt in X (Pixel im Contour-Bild)
+#ifdef SHOW_MOSAIK
+    cv::Mat show_seg;                   //!< Ausgabebild für Mosaik
+#endif
+
+    cv::Mat diff, back;                         //!< Differenzbild, Hintergrundbild (nur Bildschirmausgabe)
+    bg_model bg;                                //!< Hintergrundmodell auf der Auflösung von in[]
+    uint8_t first_in = 0, last_in = MAX_IN-1;   //!< Ringzähler
+    int anz_zero[MAX_IN] = {-1};                //!< Speicher für NonZero-Werte
+    struct timeval now[MAX_IN];                 //!< Aufnahme-Zeitpunkt
+
+    // ------------- state-machine -------------
+    uint16_t state = 0;                 //!< wird in @ref control() verwendet
+    char pic_name[512];                 //!< Dateiname im Bildmodus
+    int frame_counter = 0;              //!< Dient zum Zählen der abgespeicherten frames.
+    int nachlauf_counter = 0;
+    int bewegung_counter = 0;           //!< Anzahl erkannter Bewegungen bei inaktiver Überwachung
+    struct timeval rec_start;           //!< Aufnahme-Zeitpunkt des ersten Bildes im Video. @see @ref rec_time()
+    struct timeval trail_start;         //!< Aufnahme-Zeitpunkt des ersten Bildes im Nachlauf. @see @ref trail_time()
+
+    // ------------- CSV-Protokoll -------------
+    std::ofstream csv;                  //!< Protokoll je Bild. @see @ref open_csv()
+    uint64_t csv_frame = 0;             //!< laufende Bild-Nr. im Protokoll
+    struct timeval csv_start;           //!< Aufnahme-Zeitpunkt des ersten Bildes im Protokoll
+
+#ifdef USE_HARRIS_DETECTOR
+    cv::Mat harrisCorners;
+    HarrisDetector harris;
+#endif
+
+#ifdef USE_FEATURE_DETECTOR
+    cv::Ptr<cv::FeatureDetector> detector;
+    std::vector<cv::KeyPoint> pyrKeypoints;
+#endif
+};
+
+#endif
+
+//! @} MotionDetector
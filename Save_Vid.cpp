@@ -0,0 +1,595 @@
+/*! ------------------------------------------
+ * @addtogroup Save_Vid
+ * @{
+ *
+ * @file    Save_Vid.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2021-11-28
+ * @brief   Implementierung der class @ref save_video.
+ *
+ * @copyright Copyright (c) 2021, 2022, 2023 Ulrich Buettemeier, Stemwede
+ */
+
+#include <cstring>
+
+#include "Save_Vid.hpp"
+
+/*! ----------------------------------------------
+ * @brief Destroy the save vid object
+ */
+save_video::~save_video () 
+{
+    stop_async();
+    if (vw != NULL)     // vw = pointer to VideoWriter
+        vw->release();
+    vw = NULL;
+}
+
+/*! ----------------------------------------------
+ * @brief Hintergrund-Modus einschalten.\n
+ *        Ein Worker-Thread übernimmt den cv::VideoWriter.
+ * @param depth Tiefe der Warteschlange in Bildern. depth <= 0 schaltet in den synchronen Modus.
+ * @param policy Verhalten bei voller Warteschlange. @see @ref save_video_policy
+ */
+void save_video::set_async (int depth, int policy)
+{
+    stop_async();
+    if (depth <= 0)
+        return;
+
+    this->policy = policy;
+    queue.clear();
+    queue.resize (depth);
+    q_head = q_count = 0;
+    ende = false;
+    th = new std::thread (worker, this);
+}
+
+/*! ----------------------------------------------
+ * @brief Hintergrund-Modus beenden.\n
+ *        Alle Aufträge in der Warteschlange werden noch abgearbeitet.
+ */
+void save_video::stop_async ()
+{
+    if (th == NULL)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(q_mtx);
+        ende = true;
+    }
+    q_not_empty.notify_all();
+    th->join();
+    delete th;
+    th = NULL;
+}
+
+/*! ----------------------------------------------
+ * @brief Reserviert einen Slot am Ende der Warteschlange.\n
+ *        Der Slot wird vom Aufrufer befüllt und mit <q_count++> unter <q_mtx> freigegeben.
+ * @param may_drop true: bei voller Warteschlange und @ref SV_DROP wird NULL geliefert.
+ * @param always_drop true: bei voller Warteschlange wird unabhängig von @ref policy NULL geliefert.
+ * @return Slot oder NULL. Bei != NULL ist <q_mtx> gesperrt!
+ */
+struct _sv_job_ *save_video::push_job (bool may_drop, bool always_drop)
+{
+    std::unique_lock<std::mutex> lk(q_mtx);
+    if (q_count >= queue.size()) {
+        if (always_drop)
+            return NULL;
+        if (may_drop && (policy == SV_DROP)) {
+            ++dropped;
+            return NULL;
+        }
+        q_not_full.wait (lk, [this]{ return q_count < queue.size(); });
+    }
+    lk.release();       // q_mtx bleibt gesperrt bis der Auftrag eingetragen ist.
+    return &queue[(q_head + q_count) % queue.size()];
+}
+
+/*! ----------------------------------------------
+ * @brief Worker-Thread: arbeitet die Warteschlange ab.
+ */
+void save_video::worker (save_video *sv)
+{
+    struct _sv_job_ job;
+
+    while (1) {
+        {
+            std::unique_lock<std::mutex> lk(sv->q_mtx);
+            sv->q_not_empty.wait (lk, [sv]{ return sv->q_count > 0 || sv->ende; });
+            if (sv->q_count == 0)
+                break;                  // ende und Warteschlange leer
+
+            // Auftrag übernehmen. cv::Mat wird nur getauscht, damit die Puffer im Slot erhalten bleiben.
+            struct _sv_job_ &slot = sv->queue[sv->q_head];
+            job.cmd = slot.cmd;
+            cv::swap (job.image, slot.image);
+            job.tv = slot.tv;
+            job.has_now = slot.has_now;
+            job.text.swap (slot.text);
+            job.draw_date = slot.draw_date;
+            job.fname.swap (slot.fname);
+            job.w = slot.w;
+            job.h = slot.h;
+            job.fps = slot.fps;
+            sv->q_head = (sv->q_head + 1) % sv->queue.size();
+            --sv->q_count;
+        }
+        sv->q_not_full.notify_one();
+
+        switch (job.cmd) {
+            case _sv_job_::JOB_OPEN:
+                if (!sv->do_open (job.fname, job.w, job.h, job.fps))
+                    cout << "cant open " << job.fname << endl;
+                break;
+            case _sv_job_::JOB_FRAME:
+                sv->do_write (job.image, (job.has_now) ? &job.tv : NULL, job.text.c_str(), job.draw_date, true);
+                break;
+            case _sv_job_::JOB_PREROLL:
+                sv->do_buffer (job.image, job.tv, job.text.c_str());
+                break;
+            case _sv_job_::JOB_CLOSE:
+                sv->do_close();
+                break;
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief   open the video\n
+ *          Im Hintergrund-Modus wird nur der Auftrag eingetragen. Der Rückgabewert ist dann immer true.
+ */
+int save_video::open(std::string fname, int w, int h, double fps) 
+{
+    if (th == NULL)
+        return do_open (fname, w, h, fps);
+
+    struct _sv_job_ *job = push_job (false);    // open wird nie verworfen
+    job->cmd = _sv_job_::JOB_OPEN;
+    job->fname = fname;
+    job->w = w;
+    job->h = h;
+    job->fps = fps;
+    ++q_count;
+    q_mtx.unlock();
+    q_not_empty.notify_one();
+
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief   open the video\n
+ *          Der Encoder kommt aus @ref codec. @see @ref sv_encoder \n
+ *          MJPG  macht keine gray videos. \n 
+ *          Der Pointer @ref vw zeigt auf cv::VideoWriter().
+ * @param fps Framerate des Videos, z.B. --fps. Die Bilder werden nach ihrem Zeitstempel auf dieses Raster gelegt.
+ */
+int save_video::do_open(std::string fname, int w, int h, double fps) 
+{
+    bool ret = true;
+    if (vw != NULL)     // vw = pointer to VideoWriter
+        do_close();
+
+    width = w;
+    height = h;
+    frame_counter = 0;
+    out_fps = (fps > 0) ? fps : SV_FPS;     // Framerate of the created video stream
+    t0_valid = false;
+    next_slot = 0;
+
+    vw = sv_encoder::create (codec, fname, out_fps, Size(width, height), !make_gray);
+    if (!vw->isOpened()) {
+        delete vw;
+        vw = NULL;
+        ret = false;
+        akt_fname.clear();
+    } else {
+        akt_fname = fname;
+        cue_slot = -1;
+        if (sidecar) {
+            vtt.open (sidecar_name (fname).c_str(), std::ios::out | std::ios::trunc);
+            vtt << "WEBVTT\n\n";
+        }
+        flush_preroll ();   // Bilder vor dem Auslösen an den Anfang des Videos
+    }
+
+    return ret;
+}
+
+/*! ----------------------------------------------
+ * @brief Encoder einstellen. c sollte mit @ref sv_encoder::probe() ermittelt sein.
+ * @note Im Hintergrund-Modus vor @ref set_async() aufrufen.
+ */
+void save_video::set_codec (const struct _sv_codec_ &c)
+{
+    codec = c;
+    if (codec.backend == SV_ENC_AUTO)       // nicht ermittelt: wie bisher
+        codec.backend = SV_ENC_MJPG;
+    if ((codec.backend == SV_ENC_MJPG) || (codec.container == SV_CONT_AUTO))
+        codec.container = (codec.backend == SV_ENC_MJPG) ? SV_CONT_AVI : SV_CONT_MKV;
+}
+
+/*! ----------------------------------------------
+ * @brief Pre-Roll einstellen.
+ * @param ms Max. Länge des Pre-Roll in [ms]. 0 schaltet den Pre-Roll aus.
+ * @param kbyte Max. Speicher für den Pre-Roll in [kB].
+ * @note Im Hintergrund-Modus vor @ref set_async() aufrufen.
+ */
+void save_video::set_preroll (int ms, int kbyte)
+{
+    preroll_ms = (ms > 0) ? ms : 0;
+    preroll_max_bytes = (kbyte > 0) ? (size_t)kbyte * 1024 : 0;
+    if ((preroll_ms == 0) || (preroll_max_bytes == 0)) {
+        preroll.clear();
+        preroll_bytes = 0;
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Ein Bild in den Pre-Roll aufnehmen.\n
+ *        Wird im Idle-Betrieb für jedes Bild aufgerufen. Bei geöffnetem Video wird das Bild ignoriert.
+ *        Im Hintergrund-Modus übernimmt der Worker-Thread die JPEG-Komprimierung. 
+ *        Ist die Warteschlange voll, wird das Bild immer verworfen.
+ * @param src Bild
+ * @param tv Aufnahme-Zeitpunkt
+ * @param str optionaler Zusatztext
+ */
+void save_video::buffer (cv::Mat src, const struct timeval *tv, const char *str)
+{
+    if ((preroll_ms == 0) || (preroll_max_bytes == 0))
+        return;
+
+    if (th == NULL) {
+        do_buffer (src, *tv, str);
+        return;
+    }
+
+    struct _sv_job_ *job = push_job (true, true);
+    if (job == NULL)
+        return;
+
+    job->cmd = _sv_job_::JOB_PREROLL;
+    src.copyTo (job->image);
+    job->tv = *tv;
+    job->text = (str == NULL) ? "" : str;
+    ++q_count;
+    q_mtx.unlock();
+    q_not_empty.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief Bild JPEG-komprimieren und in den Pre-Roll eintragen.\n
+ *        Anschliessend werden die ältesten Bilder verdrängt, bis Zeit- und Speichergrenze eingehalten sind.
+ */
+void save_video::do_buffer (cv::Mat &src, const struct timeval &tv, const char *str)
+{
+    if (vw != NULL)     // Video ist offen. Das Bild gehört nicht in den Pre-Roll.
+        return;
+
+    static const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, SV_PREROLL_QUALITY};
+
+    preroll.emplace_back();
+    struct _preroll_frame_ &f = preroll.back();
+    f.jpg.swap (preroll_spare);             // Puffer eines verdrängten Bildes wiederverwenden
+    cv::imencode (".jpg", src, f.jpg, params);
+    f.tv = tv;
+    f.text = (str == NULL) ? "" : str;
+    preroll_bytes += f.jpg.size();
+
+    const long long newest = (long long)tv.tv_sec * 1000ll + tv.tv_usec / 1000;
+    while (!preroll.empty()) {
+        struct _preroll_frame_ &old = preroll.front();
+        long long age = newest - ((long long)old.tv.tv_sec * 1000ll + old.tv.tv_usec / 1000);
+        if ((age <= preroll_ms) && (preroll_bytes <= preroll_max_bytes))
+            break;
+
+        preroll_bytes -= old.jpg.size();
+        preroll_spare.swap (old.jpg);
+        preroll.pop_front();
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Pre-Roll in das gerade geöffnete Video schreiben und leeren.
+ */
+void save_video::flush_preroll ()
+{
+    while (!preroll.empty()) {
+        struct _preroll_frame_ &f = preroll.front();
+        cv::Mat img = cv::imdecode (cv::Mat(f.jpg), cv::IMREAD_COLOR);
+        if (!img.empty())
+            do_write (img, &f.tv, f.text.c_str(), true, true);
+
+        preroll_bytes -= f.jpg.size();
+        preroll_spare.swap (f.jpg);
+        preroll.pop_front();
+    }
+    preroll_bytes = 0;
+}
+
+/*! ----------------------------------------------
+ * @brief close the video\n
+ *        Im Hintergrund-Modus wird nur der Auftrag eingetragen.
+ */
+void save_video::close()
+{
+    if (th == NULL) {
+        do_close();
+        return;
+    }
+
+    struct _sv_job_ *job = push_job (false);    // close wird nie verworfen
+    job->cmd = _sv_job_::JOB_CLOSE;
+    ++q_count;
+    q_mtx.unlock();
+    q_not_empty.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief close the video\n
+ * Pointer @ref vw wird freigegeben.
+ */
+void save_video::do_close()
+{
+    if (vw != NULL)     // vw = pointer to VideoWriter
+        vw->release();
+
+    delete vw;
+    vw = NULL;
+
+    if (vtt.is_open()) {
+        write_cue (next_slot);      // letzter Untertitel endet mit dem Video
+        vtt.close();
+    }
+
+    if ((store != NULL) && !akt_fname.empty()) {    // Quota und Freiplatz über alle Tage macht der Index
+        char meta[80];
+        snprintf (meta, sizeof(meta), "frames=%i,sec=%.1f,codec=%s", 
+                  (int)frame_counter, next_slot / out_fps, sv_encoder::name (codec.backend));
+        store->add (akt_fname, meta);
+    }
+
+    std::lock_guard<std::mutex> lk(list_mtx);
+    if (!akt_fname.empty())
+        file_liste.push_back (akt_fname);
+    akt_fname.clear();
+
+    if (maxvideo >= 0) {
+        while (file_liste.size() > (size_t)maxvideo) {      // Max. Anzahl der Dateien überschritten. 
+            std::remove (file_liste[0].c_str());            // Datei löschen
+            std::remove (sidecar_name (file_liste[0]).c_str());     // Untertitel, falls vorhanden
+            if (store != NULL)
+                store->remove (file_liste[0]);              // Eintrag aus dem Index
+            file_liste.erase(file_liste.begin());           // Eintrag 0 aus Liste löschen
+        }
+    }
+}
+
+/*! ----------------------------------------
+ * @brief Variable @ref maxvideo wird ein Wert zugewiesen.
+ * @param wert Neuer Wert für @ref maxvideo.
+ */
+void save_video::set_maxvideo (int wert)
+{
+    maxvideo = wert;
+}
+
+/*! --------------------------------
+ * @brief Die Fileliste wird im Terminal angezeigt.
+ */
+void save_video::show_fileliste ()
+{
+    std::lock_guard<std::mutex> lk(list_mtx);
+    cout << "------ Fileliste Max=" << maxvideo << " Ist=" << file_liste.size() << " --------\n";
+    for (size_t i=0; i<file_liste.size(); i++) {
+        cout << file_liste[i] << endl;
+    }
+
+    cout << endl;
+}
+
+/*! --------------------------------
+ * @brief Statistik des Hintergrund-Modus im Terminal anzeigen.
+ */
+void save_video::show_stat ()
+{
+    cout << "-------- save_video ---------\n";
+    cout << "repeated:   " << dup_frames << endl;
+    cout << "late:       " << late_frames << endl;
+    if (th == NULL) {
+        cout << "mode:       synchron\n";
+        return;
+    }
+    cout << "mode:       async, " << ((policy == SV_DROP) ? "drop" : "block") << endl;
+    cout << "queue:      " << queue.size() << endl;
+    cout << "high water: " << queue_high_water << endl;
+    cout << "dropped:    " << dropped << endl;
+}
+
+/*! ----------------------------------------------
+ * @brief write the frame to the video\n
+ * Im Hintergrund-Modus wird das Bild in die Warteschlange kopiert. Die Verarbeitung macht der Worker-Thread.
+ * @param src Picture to save in Video
+ * @param ext_now Zeitstempel
+ * @param str optionaler Zusatztext
+ * @param draw_date \n 
+ *                  1: Datum im Bild eintragen\n
+ *                  0: kein Datum eintragen.
+ * 
+ */
+void save_video::write(cv::Mat src, const struct timeval *tv, const char *str, bool draw_date)
+{
+    if (th == NULL) {
+        do_write (src, tv, str, draw_date);
+        return;
+    }
+
+    struct _sv_job_ *job = push_job (true);
+    if (job == NULL)
+        return;                                 // SV_DROP: Warteschlange ist voll
+
+    job->cmd = _sv_job_::JOB_FRAME;
+    src.copyTo (job->image);                    // Puffer im Slot wird wiederverwendet
+    job->has_now = (tv != NULL);
+    if (tv != NULL)
+        job->tv = *tv;
+    job->text = (str == NULL) ? "" : str;
+    job->draw_date = draw_date;
+    ++q_count;
+    if ((int)q_count > queue_high_water)
+        queue_high_water = q_count;
+    q_mtx.unlock();
+    q_not_empty.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief write the frame to the video\n
+ * Sollte das Flag {@ref make_gray} gesetzt sein, wird ein Graustufenvideo erstellt.\n
+ * Mit Zeitstempel wird das Bild auf das Raster von @ref out_fps gelegt: Rasterplatz = (tv - t0) * out_fps.
+ * Freie Plätze davor werden mit dem vorherigen Bild gefüllt. Ist der Platz schon belegt, wird das Bild verworfen.
+ * Mit @ref sidecar kommen Zeitstempel und Text in die .vtt-Datei.
+ * @param tv Aufnahme-Zeitpunkt oder NULL. NULL: das Bild kommt auf den nächsten Platz.
+ * @param take true: der Puffer von src darf übernommen werden (Worker-Thread, Pre-Roll). Spart die Kopie.
+ */
+void save_video::do_write(cv::Mat &src, const struct timeval *tv, const char *str, bool draw_date, bool take)
+{
+    if (vw == NULL)     // vw = pointer to VideoWriter
+        return;
+
+    long long slot = next_slot;
+    if (tv != NULL) {
+        if (!t0_valid) {
+            t0 = *tv;
+            t0_valid = true;
+        }
+        long long dt = (long long)(tv->tv_sec - t0.tv_sec) * 1000000ll + (tv->tv_usec - t0.tv_usec);    // [us]
+        slot = (long long)(dt * out_fps / 1000000.0 + 0.5);
+        if (slot < next_slot) {         // zu früh: Platz ist schon belegt
+            ++late_frames;
+            return;
+        }
+        if ((next_slot > 0) && ((slot - next_slot) * 1000.0 / out_fps > SV_MAX_GAP)) {  // Sprung: t0 neu festlegen
+            t0.tv_sec = tv->tv_sec;
+            t0.tv_usec = tv->tv_usec;
+            long long back = (long long)(next_slot * 1000000.0 / out_fps);
+            t0.tv_sec -= back / 1000000ll;
+            t0.tv_usec -= back % 1000000ll;
+            if (t0.tv_usec < 0) {
+                t0.tv_usec += 1000000;
+                --t0.tv_sec;
+            }
+            slot = next_slot;
+        }
+    }
+
+    if (next_slot > 0) {
+        for (; next_slot < slot; next_slot++) {    // Lücke: vorheriges Bild wiederholen
+            vw->write ((make_gray) ? gray_frame[out_idx ^ 1] : out_frame[out_idx ^ 1]);
+            ++dup_frames;
+        }
+    }
+
+    cv::Mat &out = out_frame[out_idx];
+    if ((src.cols != width) || (src.rows != height))
+        cv::resize (src, out, Size(width, height), INTER_LINEAR);   // resize video
+    else if (take)
+        cv::swap (out, src);        // Kamerabild (--record raw): Puffer übernehmen, keine Kopie
+    else
+        src.copyTo (out);           // out wird noch für Lücken gebraucht, src gehört dem Aufrufer
+
+    if (make_gray)      // Graustufenbild in eigenen Puffer: in-place würde je Bild neu anlegen
+        cv::cvtColor (out, gray_frame[out_idx], cv::COLOR_BGR2GRAY);
+    cv::Mat &frame = (make_gray) ? gray_frame[out_idx] : out;
+
+    if (draw_date) {
+        time_t sec = (tv != NULL) ? tv->tv_sec : time(NULL);
+        if (sidecar) {              // Untertitel statt Text im Bild
+            write_cue (slot);
+            char buf[64];
+            struct tm t;
+            localtime_r (&sec, &t);
+            sprintf (buf, "%i / %02i.%02i.%i | %02i:%02i:%02i | ", frame_counter.load(),
+                     t.tm_mday, t.tm_mon+1, t.tm_year+1900, t.tm_hour, t.tm_min, t.tm_sec);
+            cue_text = buf;
+            cue_text += (str == NULL) ? "" : str;
+            cue_slot = slot;
+        } else
+            write_date_to_pic (frame, &sec, str);   // Zeit ins Bild schreiben
+    }
+    // ------------------- Bild speichern --------------------------------
+    vw->write (frame);     // write video
+    ++frame_counter;
+    next_slot = slot + 1;
+    out_idx ^= 1;           // out ist jetzt das vorherige Bild
+}
+
+/*! ----------------------------------------------
+ * @brief Offenen Untertitel in die .vtt-Datei schreiben. Er gilt bis zum Rasterplatz end_slot.
+ */
+void save_video::write_cue (long long end_slot)
+{
+    if ((cue_slot < 0) || !vtt.is_open())
+        return;
+
+    long long ms[2] = { (long long)(cue_slot * 1000.0 / out_fps), (long long)(end_slot * 1000.0 / out_fps) };
+    char buf[64];
+    for (int i=0; i<2; i++) {
+        sprintf (buf, "%02lld:%02lld:%02lld.%03lld", ms[i] / 3600000, (ms[i] / 60000) % 60, (ms[i] / 1000) % 60, ms[i] % 1000);
+        vtt << buf << ((i == 0) ? " --> " : "\n");
+    }
+    vtt << cue_text << "\n\n";
+    cue_slot = -1;
+}
+
+/*! ----------------------------------------------
+ * @brief Name der Untertitel-Datei: Endung des Videos durch .vtt ersetzt.
+ */
+std::string save_video::sidecar_name (const std::string &fname)
+{
+    size_t dot = fname.rfind ('.');
+    size_t slash = fname.rfind ('/');
+    if ((dot == std::string::npos) || ((slash != std::string::npos) && (dot < slash)))
+        return fname + ".vtt";
+    return fname.substr (0, dot) + ".vtt";
+}
+
+/*! ----------------------------------------------
+ * @brief   Set the gray flag
+ * @param gray_vid New state for @ref make_gray.
+ * @return  Immer EXIT_SUCCESS
+ */
+int save_video::set_gray (bool gray_vid) 
+{
+    make_gray = gray_vid;
+    return EXIT_SUCCESS;
+}
+
+/*! ----------------
+ * @brief
+ */
+bool save_video::get_gray_flag ()
+{
+    return make_gray;
+}
+
+/*! ----------------------------------------------
+ * @brief Zeitstempel und Zusatztext im Bild eintragen
+ * @param src Picture 
+ * @param ext_now Zeitstempel
+ * @param str optionaler Zusatztext
+ */
+void save_video::write_date_to_pic (cv::Mat &src, time_t *ext_now, const char *str)
+{
+    time_t now = (ext_now == NULL) ? time(NULL) : *ext_now;
+
+    // ------------------ Zeitstempel im Bild eintragen ----------------------
+    // Vorgerendert statt cv::putText(): Datum/Uhrzeit einmal pro Sekunde, Zähler und Text aus dem Atlas.
+    std::lock_guard<std::mutex> lk(overlay_mtx);    // wird auch vom Bildmodus in control() aufgerufen
+    overlay.draw (src,                              // target image
+                  cv::Point(10, 20),                // top-left position
+                  frame_counter.load(), now, str,
+                  (make_gray) ? cv::Scalar(255) : CV_RGB(118, 185, 0));     // font color
+}
+
+//! @} Save_Vid
@@ -7,7 +7,18 @@
  * @date    2021-11-28
  * @brief   Class zum speichern von Video's.\n
  * Ein Video wird durch speichern der Einzelbilder erstellt.\n 
- * Eine Graustufen-Konvertierung ist möglich.
+ * Eine Graustufen-Konvertierung ist möglich.\n
+ * Mit @ref save_video::set_async() arbeitet die Klasse im Hintergrund-Modus: \n
+ * open(), write() und close() legen nur einen Auftrag in eine begrenzte Warteschlange.
+ * Ein Worker-Thread besitzt den cv::VideoWriter und erledigt resize, Farbkonvertierung, Zeitstempel und Encoding.\n
+ * Mit @ref save_video::set_preroll() werden die Bilder vor der Aufnahme JPEG-komprimiert im Speicher gehalten
+ * (Pre-Roll) und beim nächsten open() an den Anfang des Videos geschrieben.\n
+ * Der Encoder (H.264 oder MJPG) wird mit @ref save_video::set_codec() gewählt. @see @ref sv_encoder \n
+ * cv::VideoWriter kennt nur eine feste Framerate. Die Bilder werden deshalb nach ihrem Aufnahme-Zeitpunkt
+ * auf das Raster der Framerate aus open() gelegt: Lücken werden mit dem Vorgängerbild gefüllt,
+ * ein zweites Bild im selben Rasterplatz wird verworfen. Das Video läuft so in Echtzeit.\n
+ * Mit @ref save_video::set_sidecar() kommen Zeitstempel und Zusatztext nicht ins Bild, sondern als Untertitel
+ * in eine WebVTT-Datei neben dem Video (out3.mkv => out3.vtt). mpv und VLC laden sie automatisch.
  * 
  * @copyright Copyright (c) 2021, 2022, 2023 Ulrich Buettemeier, Stemwede
  */
@@ -18,10 +29,21 @@
 #include <iostream>
 #include <stdio.h>
 #include <time.h>
+#include <sys/time.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "opencv2/opencv.hpp"
 
+#include "storage.hpp"
+#include "sv_encoder.hpp"
+#include "text_overlay.hpp"
+
 #define USE_CVD_
 #ifdef USE_CVD
     #include "../../OpenCVD/include/opencvd.hpp"
@@ -30,6 +52,45 @@
 using namespace std;
 using namespace cv;
 
+#define SV_QUEUE_DEPTH 8            //!< Default Tiefe der Warteschlange im Hintergrund-Modus. @see @ref save_video::set_async()
+#define SV_PREROLL_TIME 2000        //!< Default Pre-Roll in [ms]. @see @ref save_video::set_preroll()
+#define SV_PREROLL_MEM 16384        //!< Default Speichergrenze für den Pre-Roll in [kB].
+#define SV_PREROLL_QUALITY 80       //!< JPEG-Qualität der Pre-Roll Bilder.
+#define SV_FPS 10                   //!< Default Framerate des Videos. @see @ref save_video::open()
+#define SV_MAX_GAP 2000             //!< Grössere Lücken in [ms] werden nicht aufgefüllt (z.B. Uhr verstellt).
+
+/*! -------------------------------
+ * @brief Verhalten von @ref save_video::write() bei voller Warteschlange.
+ */
+enum save_video_policy {
+    SV_DROP = 0,            //!< Bild verwerfen und zählen. Die Bewegungserkennung wird nie aufgehalten.
+    SV_BLOCK = 1,           //!< Warten, bis wieder Platz ist.
+};
+
+/*! -------------------------------
+ * @brief Auftrag für den Worker-Thread.
+ */
+struct _sv_job_ {
+    enum { JOB_OPEN, JOB_FRAME, JOB_CLOSE, JOB_PREROLL } cmd;
+    cv::Mat image;          //!< JOB_FRAME, JOB_PREROLL: Bild. Der Puffer bleibt im Slot und wird wiederverwendet.
+    struct timeval tv;      //!< JOB_FRAME, JOB_PREROLL: Zeitstempel
+    bool has_now;           //!< JOB_FRAME: false, wenn write() ohne Zeitstempel aufgerufen wurde.
+    std::string text;       //!< JOB_FRAME, JOB_PREROLL: Zusatztext
+    bool draw_date;         //!< JOB_FRAME
+    std::string fname;      //!< JOB_OPEN
+    int w, h;               //!< JOB_OPEN
+    double fps;             //!< JOB_OPEN
+};
+
+/*! -------------------------------
+ * @brief Ein JPEG-komprimiertes Bild im Pre-Roll.
+ */
+struct _preroll_frame_ {
+    std::vector<uchar> jpg; //!< JPEG-Daten
+    struct timeval tv;      //!< Aufnahme-Zeitpunkt
+    std::string text;       //!< Zusatztext
+};
+
 /*! -------------------------------
  * @brief class for save video-data.
  */
@@ -37,198 +98,102 @@ class save_video {
 public:
     save_video (): frame_counter(0), make_gray(false) {}
     ~save_video ();
-    int open(std::string fname, int w=640, int h=480);      // open the video
+    int open(std::string fname, int w=640, int h=480, double fps=SV_FPS);     // open the video
     void close ();
-    void write(cv::Mat src, time_t *ext_now = NULL, char *str = NULL, bool draw_date = true);
+    void write(cv::Mat src, const struct timeval *tv = NULL, const char *str = NULL, bool draw_date = true);
     int get_frame_counter() {return frame_counter;}     // Get the frame counter object
     int set_gray (bool gray_vid);
     bool get_gray_flag ();
-    void write_date_to_pic (cv::Mat &src, time_t *ext_now = NULL, char *str = NULL); 
+    void write_date_to_pic (cv::Mat &src, time_t *ext_now = NULL, const char *str = NULL); 
+
+    void set_codec (const struct _sv_codec_ &c);
+    const struct _sv_codec_ &get_codec () { return codec; }
+    const char *get_ext () { return sv_encoder::ext (codec.container); }    // Dateiendung des Containers
+
+    void set_sidecar (bool on) { sidecar = on; }      // vor set_async() aufrufen
+    bool get_sidecar () { return sidecar; }
 
     void set_maxvideo (int wert);
+    int get_maxvideo () { return maxvideo; }
     void show_fileliste ();
+    void set_storage (storage *st) { store = st; }    // vor set_async() aufrufen
+    storage *get_storage () { return store; }
+
+    void set_preroll (int ms, int kbyte);
+    void buffer (cv::Mat src, const struct timeval *tv, const char *str = NULL);
+
+    void set_async (int depth, int policy = SV_DROP);
+    void stop_async ();
+    int get_queue_high_water () {return queue_high_water;}
+    int get_dropped () {return dropped;}
+    int get_dup_frames () {return dup_frames;}
+    int get_late_frames () {return late_frames;}
+    void show_stat ();
 
 private:
+    int do_open (std::string fname, int w, int h, double fps);
+    void do_close ();
+    void do_write (cv::Mat &src, const struct timeval *tv, const char *str, bool draw_date, bool take = false);
+    void write_cue (long long end_slot);
+    static std::string sidecar_name (const std::string &fname);
+    void do_buffer (cv::Mat &src, const struct timeval &tv, const char *str);
+    void flush_preroll ();
+
+    struct _sv_job_ *push_job (bool may_drop, bool always_drop = false);
+    static void worker (save_video *sv);
+
     cv::VideoWriter *vw = NULL;         //!< Pointer wird in @ref open() erzeugt. Freigegeben wird er in @ref close().
     int width;
     int height;
-    int frame_counter = 0;
+    std::atomic<int> frame_counter;
+
+    // ------------- Raster der Framerate --------------
+    double out_fps = SV_FPS;            //!< Framerate des geöffneten Videos
+    struct timeval t0;                  //!< Aufnahme-Zeitpunkt von Rasterplatz 0
+    bool t0_valid = false;              //!< false: das nächste Bild mit Zeitstempel legt t0 fest
+    long long next_slot = 0;            //!< nächster freier Rasterplatz
+    cv::Mat out_frame[2];               //!< aktuelles und vorheriges Ausgabebild. Das vorherige füllt Lücken.
+    int out_idx = 0;                    //!< Index des aktuellen Bildes in out_frame[]
+    cv::Mat gray_frame[2];              //!< Graustufen-Ausgabe bei @ref make_gray, gleicher Index wie out_frame[]
+    std::atomic<int> dup_frames {0};    //!< Anzahl eingefügter Wiederholungen
+    std::atomic<int> late_frames {0};   //!< Anzahl verworfener Bilder (Rasterplatz schon belegt)
+
+    // ------------- Untertitel (WebVTT) --------------
+    bool sidecar = false;               //!< true: Zeitstempel und Text in die .vtt-Datei statt ins Bild
+    std::ofstream vtt;                  //!< Untertitel des geöffneten Videos
+    long long cue_slot = -1;            //!< Rasterplatz des offenen Untertitels. -1 = keiner.
+    std::string cue_text;               //!< Text des offenen Untertitels. Er endet mit dem nächsten Bild.
     int maxvideo = -1;                  //!< Maximale Anzahl an Videodateien. \n Wird die Anzahl überschritten, wird die erste Datei gelöscht. \n Bei maxvideo = -1 gibt es keine Begrenzung.
     std::string akt_fname;
     vector <std::string> file_liste;    //!< Liste enthält die Dateinamen.
+    std::mutex list_mtx;                //!< schützt @ref file_liste
+    storage *store = NULL;              //!< Index aller Videos für --quota und --minfree. NULL = ohne Index.
     bool make_gray = false;             //!< bei true wird das Bild/Video als Graustufe gespeichert. @see @ref set_gray()
+    text_overlay overlay;               //!< Textzeile mit Cache. @see @ref write_date_to_pic()
+    std::mutex overlay_mtx;             //!< schützt @ref overlay
+    struct _sv_codec_ codec;            //!< Encoder. Bis @ref set_codec() MJPG/AVI wie bisher.
+
+    // ------------- Pre-Roll --------------
+    int preroll_ms = 0;                 //!< Max. Länge des Pre-Roll in [ms]. 0 = kein Pre-Roll.
+    size_t preroll_max_bytes = 0;       //!< Max. Speicher für den Pre-Roll in [Byte].
+    size_t preroll_bytes = 0;           //!< Aktueller Speicherbedarf des Pre-Roll.
+    std::deque <struct _preroll_frame_> preroll;    //!< Pre-Roll, ältestes Bild vorne.
+    std::vector<uchar> preroll_spare;   //!< Puffer eines verdrängten Bildes. Wird für das nächste Bild wiederverwendet.
+
+    // ------------- Hintergrund-Modus --------------
+    std::thread *th = NULL;             //!< Worker-Thread. NULL: synchroner Modus.
+    vector <struct _sv_job_> queue;     //!< Ringpuffer der Aufträge. Die Slots werden wiederverwendet.
+    size_t q_head = 0;                  //!< ältester Auftrag
+    size_t q_count = 0;                 //!< Anzahl Aufträge
+    int policy = SV_DROP;               //!< @see @ref save_video_policy
+    bool ende = false;                  //!< beendet den Worker-Thread
+    std::mutex q_mtx;
+    std::condition_variable q_not_empty;
+    std::condition_variable q_not_full;
+    std::atomic<int> queue_high_water {0};  //!< Max. Füllstand der Warteschlange
+    std::atomic<int> dropped {0};           //!< Anzahl verworfener Bilder (nur bei @ref SV_DROP)
 };
 
-/*! ----------------------------------------------
- * @brief Destroy the save vid object
- */
-save_video::~save_video () 
-{
-    if (vw != NULL)     // vw = pointer to VideoWriter
-        vw->release();
-    vw = NULL;
-}
-
-/*! ----------------------------------------------
- * @brief   open the video\n
- *          H.264  funktioniert auf dem Raspi nicht ! \n
- *          MJPG  macht keine gray videos. \n 
- *          Der Pointer @ref vw zeigt auf cv::VideoWriter().
- */
-int save_video::open(std::string fname, int w, int h) 
-{
-    bool ret = true;
-    if (vw != NULL)     // vw = pointer to VideoWriter
-        close();
-
-    width = w;
-    height = h;
-    frame_counter = 0;
-    double fps = 5.0f;  // 10.0f    // Framerate of the created video stream. 
-                                    // Das Video wird später mit dieser Geschwindigkeit abgespielt.
-    
-    // --- H.264 Funktioniert nicht auf raspi ---
-    // vw = new cv::VideoWriter(fname, VideoWriter::fourcc('H','2','6','4'),       // used by vlc (color, grayscale). 
-    vw = new cv::VideoWriter(fname, VideoWriter::fourcc('M','J','P','G'),   
-                                fps, 
-                                Size(width, height), 
-                                !make_gray);
-    if (vw == NULL) {
-        ret = false;
-        akt_fname.clear();
-    } else 
-        akt_fname = fname;
-
-    return ret;
-}
-
-/*! ----------------------------------------------
- * @brief close the video\n
- * Pointer @ref vw wird freigegeben.
- */
-void save_video::close()
-{
-    if (vw != NULL)     // vw = pointer to VideoWriter
-        vw->release();
-
-    vw = NULL;
-    if (!akt_fname.empty())
-        file_liste.push_back (akt_fname);
-
-    if (maxvideo >= 0) {
-        while (file_liste.size() > (size_t)maxvideo) {      // Max. Anzahl der Dateien überschritten. 
-            std::remove (file_liste[0].c_str());            // Datei löschen
-            file_liste.erase(file_liste.begin());           // Eintrag 0 aus Liste löschen
-        }
-    }
-}
-
-/*! ----------------------------------------
- * @brief Variable @ref maxvideo wird ein Wert zugewiesen.
- * @param wert Neuer Wert für @ref maxvideo.
- */
-void save_video::set_maxvideo (int wert)
-{
-    maxvideo = wert;
-}
-
-/*! --------------------------------
- * @brief Die Fileliste wird im Terminal angezeigt.
- */
-void save_video::show_fileliste ()
-{
-    cout << "------ Fileliste Max=" << maxvideo << " Ist=" << file_liste.size() << " --------\n";
-    for (size_t i=0; i<file_liste.size(); i++) {
-        cout << file_liste[i] << endl;
-    }
-
-    cout << endl;
-}
-
-/*! ----------------------------------------------
- * @brief write the frame to the video\n
- * Sollte das Flag {@ref make_gray} gesetzt sein, wird ein Graustufenvideo erstellt.
- * @param src Picture to save in Video
- * @param ext_now Zeitstempel
- * @param str optionaler Zusatztext
- * @param draw_date \n 
- *                  1: Datum im Bild eintragen\n
- *                  0: kein Datum eintragen.
- * 
- */
-void save_video::write(cv::Mat src, time_t *ext_now, char *str, bool draw_date)
-{
-    if (vw == NULL)     // vw = pointer to VideoWriter
-        return;
-
-    cv::Mat out;
-    cv::resize (src, out, Size(width, height), INTER_LINEAR);       // resize video
-
-    if (make_gray) 
-        cv::cvtColor (out, out, cv::COLOR_BGR2GRAY);               // Graustufenbild
-
-    if (draw_date) {
-        write_date_to_pic (out, ext_now, str);      // Zeit ins Bild schreiben
-    }
-    // ------------------- Bild speichern --------------------------------
-    vw->write (out);       // write video
-    ++frame_counter;
-}
-
-/*! ----------------------------------------------
- * @brief   Set the gray flag
- * @param gray_vid New state for @ref make_gray.
- * @return  Immer EXIT_SUCCESS
- */
-int save_video::set_gray (bool gray_vid) 
-{
-    make_gray = gray_vid;
-    return EXIT_SUCCESS;
-}
-
-/*! ----------------
- * @brief
- */
-bool save_video::get_gray_flag ()
-{
-    return make_gray;
-}
-
-/*! ----------------------------------------------
- * @brief Zeitstempel und Zusatztext im Bild eintragen
- * @param src Picture 
- * @param ext_now Zeitstempel
- * @param str optionaler Zusatztext
- */
-void save_video::write_date_to_pic (cv::Mat &src, time_t *ext_now, char *str)
-{
-    char buf[512];
-    // ------------------- Zeit ermitteln ----------------------
-    struct tm t;
-    time_t now;
-
-    if (ext_now == NULL)
-        now = time(NULL);
-    else 
-        now = *ext_now;
-
-    localtime_r (&now, &t);
-    char str_buf[256];
-    strcpy (str_buf, (str == NULL) ? "" : str);
-    sprintf (buf, "%i / %02i.%02i.%i | %02i:%02i:%02i | %s", frame_counter, 
-                                            t.tm_mday, t.tm_mon+1, t.tm_year+1900, 
-                                            t.tm_hour, t.tm_min, t.tm_sec,
-                                            str_buf);
-    // ------------------ Zeitstempel im Bild eintragen ----------------------
-    cv::putText(src,                    // target image
-        buf,                            // text
-        cv::Point(10, 20),              // top-left position
-        cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
-        1.0,                            // fontScale
-        (make_gray) ? 255 : CV_RGB(118, 185, 0),   // font color
-        2);                             // thickness
-}
-
 #endif
 
 //! @} main
\ No newline at end of file
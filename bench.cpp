@@ -0,0 +1,716 @@
+/*! ------------------------------------------
+ * @defgroup bench Bench: Laufzeitmessung der Bildverarbeitung
+ * @{
+ *
+ * @file    bench.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Micro-Benchmark für die einzelnen Stufen von @ref MotionDetector::get_frame().\n
+ * Jede Stufe läuft auf synthetischen (und optional aufgezeichneten) Bildern in 640x480, 800x800 und 1920x1080.
+ * Ausgegeben werden ns/frame, Bytes/frame und Allokationen/frame.\n
+ * Die Allokationen werden gezählt, indem malloc() & Co. in diesem Programm überschrieben werden.
+ * Das erfasst sowohl operator new als auch cv::fastMalloc().
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ *
+ * @code
+ * make bench
+ * ./lookat_bench
+ * ./lookat_bench --input test.avi --iter 20
+ * @endcode
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <getopt.h>
+#include <malloc.h>
+#include <sys/time.h>
+
+#include "opencv2/opencv.hpp"
+
+#include "MotionDetector.hpp"
+#include "histogram.h"
+#include "pixdiff.hpp"
+#include "preproc.hpp"
+#include "morph.hpp"
+#include "bg_model.hpp"
+
+using namespace std;
+
+#define BENCH_FRAMES 16         //!< Anzahl unterschiedlicher Bilder je Bildgrösse
+#define BENCH_ITER 30           //!< Default für die Anzahl Durchläufe über alle Bilder. Option --iter
+
+// ------------------------ Speicherzähler ---------------------------------
+static std::atomic<bool> count_alloc(false);        //!< nur während der Messung zählen
+static std::atomic<uint64_t> alloc_bytes(0);        //!< angeforderte Bytes
+static std::atomic<uint64_t> alloc_count(0);        //!< Anzahl Allokationen
+
+extern "C" {
+void *__libc_malloc (size_t size);
+void *__libc_calloc (size_t n, size_t size);
+void *__libc_realloc (void *ptr, size_t size);
+void *__libc_memalign (size_t align, size_t size);
+void __libc_free (void *ptr);
+
+static inline void count_alloc_size (size_t size)
+{
+    if (count_alloc.load (std::memory_order_relaxed)) {
+        alloc_bytes.fetch_add (size, std::memory_order_relaxed);
+        alloc_count.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+void *malloc (size_t size) { count_alloc_size (size); return __libc_malloc (size); }
+void *calloc (size_t n, size_t size) { count_alloc_size (n * size); return __libc_calloc (n, size); }
+void *realloc (void *ptr, size_t size) { count_alloc_size (size); return __libc_realloc (ptr, size); }
+void *memalign (size_t align, size_t size) { count_alloc_size (size); return __libc_memalign (align, size); }
+void *aligned_alloc (size_t align, size_t size) { count_alloc_size (size); return __libc_memalign (align, size); }
+void free (void *ptr) { __libc_free (ptr); }
+
+int posix_memalign (void **ptr, size_t align, size_t size)
+{
+    count_alloc_size (size);
+    *ptr = __libc_memalign (align, size);
+    return (*ptr != NULL) ? 0 : ENOMEM;
+}
+}
+
+/*! -------------------------------
+ * @brief Zugriff auf die privaten Stufen von @ref MotionDetector.
+ */
+class md_bench {
+public:
+    static void make_seg (MotionDetector &md, cv::Mat basis)
+    {
+        md.first_in = (md.first_in < MAX_IN-1) ? md.first_in+1 : 0;    // Ringzähler wie in detect()
+        md.last_in = (md.last_in < MAX_IN-1) ? md.last_in+1 : 0;
+        md.make_seg (basis);
+    }
+    static void label_blobs (MotionDetector &md) { md.label_blobs (); }
+    static void render_contours (MotionDetector &md) { md.contours_valid = false; md.get_contours_pic (); }
+};
+
+/*! -------------------------------
+ * @brief Bilder einer Bildgrösse und die Zwischenergebnisse der Pipeline.\n
+ *        Jede Stufe bekommt als Eingang das Ergebnis der vorherigen Stufe.
+ */
+struct _bench_set_ {
+    std::string name;                   //!< z.B. "640x480 synth"
+    std::vector<cv::Mat> bgr;           //!< Eingangsbilder
+    std::vector<cv::Mat> gray;          //!< nach cvtColor
+    std::vector<cv::Mat> stretched;     //!< nach Histogram1D::stretch
+    std::vector<cv::Mat> boxed;         //!< nach boxFilter
+    std::vector<cv::Mat> dilated;       //!< nach dilate
+    std::vector<cv::Mat> eroded;        //!< nach erode
+    std::vector<cv::Mat> pyr1;          //!< nach dem 1. pyrDown, Eingang für make_seg
+    std::vector<cv::Mat> pyr2;          //!< nach dem 2. pyrDown
+};
+
+/*! -------------------------------
+ * @brief Ergebnis einer Stufe.
+ */
+struct _bench_result_ {
+    double ns;          //!< ns/frame
+    double bytes;       //!< Bytes/frame
+    double allocs;      //!< Allokationen/frame
+};
+
+static int iter = BENCH_ITER;
+
+/*! ----------------------------------------------
+ * @brief Stufe messen.
+ * @param n Anzahl Bilder
+ * @param stage wird für jedes Bild mit dem Index aufgerufen.
+ */
+static struct _bench_result_ measure (size_t n, const std::function<void(size_t)> &stage)
+{
+    for (size_t i=0; i<n && i<3; i++)        // warm up
+        stage (i);
+
+    alloc_bytes = 0;
+    alloc_count = 0;
+    count_alloc = true;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k=0; k<iter; k++)
+        for (size_t i=0; i<n; i++)
+            stage (i);
+    auto t1 = std::chrono::steady_clock::now();
+    count_alloc = false;
+
+    double frames = (double)iter * (double)n;
+    struct _bench_result_ r;
+    r.ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / frames;
+    r.bytes = (double)alloc_bytes.load() / frames;
+    r.allocs = (double)alloc_count.load() / frames;
+    return r;
+}
+
+/*! ----------------------------------------------
+ * @brief Ausgabe einer Zeile.
+ */
+static void report (const std::string &set_name, const char *stage, const struct _bench_result_ &r)
+{
+    cout << left << setw(20) << set_name << setw(24) << stage << right
+         << setw(14) << (long long)r.ns
+         << setw(14) << (long long)r.bytes
+         << setw(10) << fixed << setprecision(1) << r.allocs << endl;
+}
+
+/*! ----------------------------------------------
+ * @brief Synthetische Bilder: Verlauf mit Rauschen und ein wandernder Block (Bewegung).
+ */
+static void make_synthetic (struct _bench_set_ &s, cv::Size size)
+{
+    cv::RNG rng (0x1001);
+    cv::Mat base (size, CV_8UC3);
+    for (int y=0; y<size.height; y++)
+        for (int x=0; x<size.width; x++)
+            base.at<cv::Vec3b>(y, x) = cv::Vec3b (x * 255 / size.width, y * 255 / size.height, 128);
+
+    for (int i=0; i<BENCH_FRAMES; i++) {
+        cv::Mat noise (size, CV_8UC3);
+        rng.fill (noise, cv::RNG::UNIFORM, 0, 16);
+        cv::Mat f = base + noise;
+        int bw = size.width / 8;
+        int bh = size.height / 6;
+        int x = (i * size.width / BENCH_FRAMES) % (size.width - bw);
+        cv::rectangle (f, cv::Rect (x, size.height / 3, bw, bh), cv::Scalar (20, 200, 40), -1);
+        s.bgr.push_back (f);
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Aufgezeichnete Bilder aus Datei oder Verzeichnis. Werden auf size skaliert.
+ * @return false: keine Bilder gelesen.
+ */
+static bool make_recorded (struct _bench_set_ &s, const std::vector<cv::Mat> &rec, cv::Size size)
+{
+    for (size_t i=0; i<rec.size(); i++) {
+        cv::Mat f;
+        cv::resize (rec[i], f, size);
+        s.bgr.push_back (f);
+    }
+    return !s.bgr.empty();
+}
+
+/*! ----------------------------------------------
+ * @brief Bilder mit @ref frame_grabber im Replay-Modus lesen.
+ */
+static std::vector<cv::Mat> load_recorded (const std::string &path)
+{
+    std::vector<cv::Mat> rec;
+    frame_grabber g;
+
+    if (!g.open_file (path) || (g.start() != EXIT_SUCCESS)) {
+        cout << "ERROR cant open " << path << endl;
+        return rec;
+    }
+
+    cv::Mat f;
+    while ((rec.size() < BENCH_FRAMES) && g.get_newest (f)) {
+        rec.push_back (f.clone());
+    }
+    g.stop ();
+    return rec;
+}
+
+/*! ----------------------------------------------
+ * @brief Zwischenergebnisse der Pipeline einmal berechnen. Parameter wie in @ref MotionDetector::detect().
+ */
+static void prepare (struct _bench_set_ &s)
+{
+    Histogram1D h;
+
+    for (size_t i=0; i<s.bgr.size(); i++) {
+        cv::Mat g, st, bx, di, er, p1, p2;
+        cv::cvtColor (s.bgr[i], g, cv::COLOR_BGR2GRAY);
+        st = h.stretch (g, 0.0050f);
+        cv::boxFilter (st, bx, -1, cv::Size(6, 6));
+        cv::dilate (bx, di, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+        cv::erode (di, er, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+        cv::pyrDown (er, p1, cv::Size(0, 0));
+        cv::pyrDown (p1, p2, cv::Size(0, 0));
+
+        s.gray.push_back (g);
+        s.stretched.push_back (st);
+        s.boxed.push_back (bx);
+        s.dilated.push_back (di);
+        s.eroded.push_back (er);
+        s.pyr1.push_back (p1);
+        s.pyr2.push_back (p2);
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief SIMD-Pfad von @ref pixdiff gegen den skalaren Pfad prüfen.
+ */
+static void verify_pixdiff (const struct _bench_set_ &s, uint8_t thr)
+{
+    const size_t n = s.pyr1.size();
+    for (size_t i=0; i<n; i++) {
+        const cv::Mat &a = s.pyr1[i];
+        const cv::Mat &b = s.pyr1[(i + 1) % n];
+        cv::Mat d1 (a.rows, a.cols, CV_8UC1), d2 (a.rows, a.cols, CV_8UC1);
+        for (int y=0; y<a.rows; y++) {
+            int c1 = pixdiff::row (a.ptr<uint8_t>(y), b.ptr<uint8_t>(y), d1.ptr<uint8_t>(y), a.cols, thr);
+            int c2 = pixdiff::row_scalar (a.ptr<uint8_t>(y), b.ptr<uint8_t>(y), d2.ptr<uint8_t>(y), a.cols, thr);
+            if ((c1 != c2) || (memcmp (d1.ptr<uint8_t>(y), d2.ptr<uint8_t>(y), a.cols) != 0)) {
+                cout << "ERROR pixdiff " << pixdiff::simd_name() << " != scalar: " << s.name << " Bild " << i << " Zeile " << y << endl;
+                return;
+            }
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief --threads: Mosaik-Auswertung mit 1, 2 und 4 Threads. Die Zählung muss gleich sein wie seriell.\n
+ *        cv::setNumThreads() wird je Stufe einmal vor der Messung gesetzt, wie in main() beim Start.
+ */
+static void scale_tiles (const struct _bench_set_ &s, uint8_t thr)
+{
+    const size_t n = s.pyr1.size();
+    const int grids[][2] = { {8, 6}, {32, 24} };
+    const int threads[] = {1, 2, 4};
+    const int old = cv::getNumThreads();
+
+    for (const auto &g : grids) {
+        std::vector<int> ref (g[0] * g[1]), counts (g[0] * g[1]);
+        double ns1 = 0.0;
+        for (int t : threads) {
+            cv::setNumThreads (t);
+            char stage[64];
+            sprintf (stage, "tiles %ix%i --threads %i", g[0], g[1], t);
+            struct _bench_result_ r = measure (n, [&](size_t i) {
+                pixdiff::tiles (s.pyr1[i], s.pyr1[(i + 1) % n], g[0], g[1], thr, counts.data(), t);
+            });
+            report (s.name, stage, r);
+            if (t == 1)
+                ns1 = r.ns;
+            else if (r.ns > 0.0)
+                cout << left << setw(20) << s.name << "  speedup: " << fixed << setprecision(2) << ns1 / r.ns << right << endl;
+
+            for (size_t i=0; i<n; i++) {
+                pixdiff::tiles (s.pyr1[i], s.pyr1[(i + 1) % n], g[0], g[1], thr, ref.data(), 1);
+                pixdiff::tiles (s.pyr1[i], s.pyr1[(i + 1) % n], g[0], g[1], thr, counts.data(), t);
+                if (ref != counts) {
+                    cout << "ERROR pixdiff::tiles --threads " << t << " != seriell: " << s.name << " Bild " << i << endl;
+                    break;
+                }
+            }
+        }
+    }
+    cv::setNumThreads (old);
+}
+
+/*! ----------------------------------------------
+ * @brief @ref morph gegen cv::dilate() / cv::erode() prüfen. Das Ergebnis muss bitgleich sein.
+ */
+static void verify_morph (const struct _bench_set_ &s)
+{
+    cv::Mat d, e;
+    for (size_t i=0; i<s.boxed.size(); i++) {
+        morph::dilate (s.boxed[i], d, 6);
+        morph::erode (s.dilated[i], e, 6);
+        if ((pixdiff::count (d, s.dilated[i], 0) != 0) || (pixdiff::count (e, s.eroded[i], 0) != 0)) {
+            cout << "ERROR morph " << morph::simd_name() << " != cv::dilate/erode: " << s.name << " Bild " << i << endl;
+            return;
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief A/B der Erkennung: --morph cv gegen --morph vhgw mit sonst gleichen Parametern.\n
+ *        Verglichen werden diff_non_zero, falle_aktiv und die Anzahl Blobs je Bild.
+ */
+static void compare_morph (const struct _bench_set_ &s)
+{
+    MotionDetector a, b;
+    struct _geo_ wish = {-1, -1, -1, -1};
+    MotionDetector *md[2] = {&a, &b};
+    for (int k=0; k<2; k++) {
+        md[k]->properties.no_output = true;
+        md[k]->properties.replay = true;
+        md[k]->properties.morph = (k == 0) ? MORPH_OPENCV : MORPH_VHGW;
+        md[k]->reset_geo (wish, s.bgr[0].cols, s.bgr[0].rows);
+    }
+
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    size_t same = 0;
+    for (size_t i=0; i<s.bgr.size(); i++) {
+        a.feed (s.bgr[i], tv);
+        b.feed (s.bgr[i], tv);
+        same += (a.properties.diff_non_zero == b.properties.diff_non_zero) &&
+                (a.properties.falle_aktiv == b.properties.falle_aktiv) &&
+                (a.get_blobs().size() == b.get_blobs().size());
+    }
+    cout << left << setw(20) << s.name << "morph A/B: " << same << " von " << s.bgr.size() << " Bildern gleich" << right << endl;
+}
+
+/*! ----------------------------------------------
+ * @brief Schnellen Pfad (--fastpre) gegen die bisherige Kette prüfen.\n
+ *        Verglichen wird der Eingang des Mosaiks (pyr1) und die aktiven Mosaik-Felder 8x6 je Bildpaar.
+ * @param fast Ergebnis des schnellen Pfades je Bild
+ */
+static void verify_fastpre (const struct _bench_set_ &s, const std::vector<cv::Mat> &fast,
+                            const struct _bench_result_ &r_std, const struct _bench_result_ &r_fast)
+{
+    const struct _properties_ p;        // Default-Parameter von lookat
+    const size_t n = s.pyr1.size();
+    const int gx = p.grid_x, gy = p.grid_y;
+    double mad = 0.0;
+    long same = 0, total = 0;
+
+    for (size_t i=0; i<n; i++) {
+        cv::Rect r (0, 0, std::min (s.pyr1[i].cols, fast[i].cols), std::min (s.pyr1[i].rows, fast[i].rows));
+        cv::Mat d;
+        cv::absdiff (s.pyr1[i](r), fast[i](r), d);
+        mad += cv::mean (d)[0];
+
+        std::vector<int> c1 (gx * gy), c2 (gx * gy);
+        size_t j = (i + 1) % n;
+        pixdiff::tiles (s.pyr1[i](r), s.pyr1[j](r), gx, gy, (uint8_t)p.threshold, c1.data());
+        pixdiff::tiles (fast[i](r), fast[j](r), gx, gy, (uint8_t)p.threshold, c2.data());
+        for (int k=0; k<gx*gy; k++) {
+            same += ((c1[k] > p.NonZero_seg) == (c2[k] > p.NonZero_seg));
+            ++total;
+        }
+    }
+
+    cout << left << setw(20) << s.name << "fastpre: Abweichung " << fixed << setprecision(2) << mad / n
+         << " Graustufen, Mosaik-Felder gleich " << setprecision(1) << 100.0 * same / total << " %"
+         << ", Faktor " << setprecision(2) << r_std.ns / r_fast.ns << right << endl;
+}
+
+/*! ----------------------------------------------
+ * @brief BGR => YUYV 4:2:2 als CV_8UC2, wie es die Kamera mit --pixfmt yuyv liefert.
+ */
+static cv::Mat make_yuyv (const cv::Mat &bgr)
+{
+    cv::Mat yuv;
+    cv::cvtColor (bgr, yuv, cv::COLOR_BGR2YUV);
+    cv::Mat dst (bgr.rows, bgr.cols & ~1, CV_8UC2);
+    for (int y=0; y<dst.rows; y++) {
+        const uint8_t *s = yuv.ptr<uint8_t>(y);
+        uint8_t *d = dst.ptr<uint8_t>(y);
+        for (int x=0; x<dst.cols; x+=2, s+=6, d+=4) {
+            d[0] = s[0];                            // Y0
+            d[1] = (uint8_t)((s[1] + s[4]) / 2);    // U
+            d[2] = s[3];                            // Y1
+            d[3] = (uint8_t)((s[2] + s[5]) / 2);    // V
+        }
+    }
+    return dst;
+}
+
+/*! ----------------------------------------------
+ * @brief Alle Stufen für einen Bildsatz messen.
+ */
+static void run_set (struct _bench_set_ &s)
+{
+    const size_t n = s.bgr.size();
+    Histogram1D h;
+
+    prepare (s);
+
+    // ---- die einzelnen Stufen. Ausgabe jeweils in einen wiederverwendeten Puffer wie in detect() ----
+    cv::Mat out;
+    report (s.name, "copyTo (Ignor-Bereich)", measure (n, [&](size_t i) {
+        s.bgr[i].copyTo (out);
+    }));
+    report (s.name, "cvtColor", measure (n, [&](size_t i) {
+        cv::cvtColor (s.bgr[i], out, cv::COLOR_BGR2GRAY);
+    }));
+    report (s.name, "Histogram1D::stretch", measure (n, [&](size_t i) {
+        h.stretch (s.gray[i], 0.0050f, out);
+    }));
+    Histogram1D hc;
+    hc.setLutCache (LUT_CACHE, LUT_STEP, LUT_TOLERANCE);
+    report (s.name, "  stretch (LUT-Cache)", measure (n, [&](size_t i) {
+        hc.stretch (s.gray[i], 0.0050f, out);
+    }));
+    report (s.name, "boxFilter", measure (n, [&](size_t i) {
+        cv::boxFilter (s.stretched[i], out, -1, cv::Size(6, 6));
+    }));
+    report (s.name, "dilate 6x", measure (n, [&](size_t i) {
+        cv::dilate (s.boxed[i], out, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+    }));
+    report (s.name, "erode 6x", measure (n, [&](size_t i) {
+        cv::erode (s.dilated[i], out, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+    }));
+    report (s.name, "morph::dilate 13x13", measure (n, [&](size_t i) {
+        morph::dilate (s.boxed[i], out, 6);
+    }));
+    report (s.name, "morph::erode 13x13", measure (n, [&](size_t i) {
+        morph::erode (s.dilated[i], out, 6);
+    }));
+    verify_morph (s);
+    report (s.name, "pyrDown 1", measure (n, [&](size_t i) {
+        cv::pyrDown (s.eroded[i], out, cv::Size(0, 0));
+    }));
+    report (s.name, "pyrDown 2", measure (n, [&](size_t i) {
+        cv::pyrDown (s.pyr1[i], out, cv::Size(0, 0));
+    }));
+
+    // ---- Vorverarbeitung bis zum Eingang des Mosaiks: bisherige Kette und --fastpre ----
+    cv::Mat g, st, a, b;
+    struct _bench_result_ r_std = measure (n, [&](size_t i) {
+        cv::cvtColor (s.bgr[i], g, cv::COLOR_BGR2GRAY);
+        h.stretch (g, 0.0050f, st);
+        cv::boxFilter (st, a, -1, cv::Size(6, 6));
+        cv::dilate (a, b, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+        cv::erode (b, a, cv::Mat(), cv::Point(-1, -1), 6, 1, 1);
+        cv::pyrDown (a, out, cv::Size(0, 0));
+    });
+    report (s.name, "preprocess", r_std);
+    std::vector<cv::Mat> fast (n);
+    struct _bench_result_ r_fast = measure (n, [&](size_t i) {
+        preproc::gray_half (s.bgr[i], g);
+        h.stretch (g, 0.0050f, st);
+        cv::boxFilter (st, a, -1, cv::Size(3, 3));
+        cv::dilate (a, b, cv::Mat(), cv::Point(-1, -1), 3, 1, 1);
+        cv::erode (b, fast[i], cv::Mat(), cv::Point(-1, -1), 3, 1, 1);
+    });
+    report (s.name, "preprocess --fastpre", r_fast);
+    report (s.name, "  preproc::gray_half", measure (n, [&](size_t i) {
+        preproc::gray_half (s.bgr[i], g);
+    }));
+    verify_fastpre (s, fast, r_std, r_fast);
+
+    // ---- Vorfilter (--skip): Vorschaubild (4x4 Stichproben je Feld) und Vergleich mit dem Vorgängerbild ----
+    cv::Mat t0, t1;
+    struct _bench_result_ r_skip = measure (n, [&](size_t i) {
+        preproc::thumb (s.bgr[i], THUMB_BLOCK, t0);
+        preproc::thumb (s.bgr[(i + 1) % n], THUMB_BLOCK, t1);
+        volatile int c = preproc::thumb_changed (t0, t1, THUMB_THR);
+        (void)c;
+    });
+    report (s.name, "skip: thumb + thumb_changed", r_skip);
+
+    // ---- --pixfmt: Graubild aus YUYV bzw. MJPEG ohne den Umweg über BGR ----
+    std::vector<cv::Mat> yuyv, jpg;
+    for (size_t i=0; i<n; i++) {
+        std::vector<uchar> buf;
+        cv::imencode (".jpg", s.bgr[i], buf);
+        jpg.push_back (cv::Mat (buf, true).reshape (1, 1));
+        yuyv.push_back (make_yuyv (s.bgr[i]));
+    }
+    report (s.name, "yuyv: BGR + cvtColor", measure (n, [&](size_t i) {
+        cv::cvtColor (yuyv[i], a, cv::COLOR_YUV2BGR_YUYV);
+        cv::cvtColor (a, g, cv::COLOR_BGR2GRAY);
+    }));
+    report (s.name, "yuyv: extractChannel", measure (n, [&](size_t i) {
+        cv::extractChannel (yuyv[i], g, 0);
+    }));
+    report (s.name, "yuyv: gray_half_yuyv", measure (n, [&](size_t i) {
+        preproc::gray_half_yuyv (yuyv[i], g);
+    }));
+    report (s.name, "mjpg: imdecode BGR", measure (n, [&](size_t i) {
+        cv::imdecode (jpg[i], cv::IMREAD_COLOR, &a);
+    }));
+    report (s.name, "mjpg: imdecode GRAY", measure (n, [&](size_t i) {
+        cv::imdecode (jpg[i], cv::IMREAD_GRAYSCALE, &g);
+    }));
+    report (s.name, "mjpg: imdecode GRAY/2", measure (n, [&](size_t i) {
+        cv::imdecode (jpg[i], cv::IMREAD_REDUCED_GRAYSCALE_2, &g);
+    }));
+
+    MotionDetector md;
+    struct _geo_ wish = {-1, -1, -1, -1};
+    md.properties.no_output = true;
+    md.properties.replay = true;
+    md.reset_geo (wish, s.bgr[0].cols, s.bgr[0].rows);
+
+    report (s.name, "make_seg", measure (n, [&](size_t i) {
+        md_bench::make_seg (md, s.pyr1[i]);
+    }));
+    report (s.name, "  label_blobs", measure (n, [&](size_t) {
+        md_bench::label_blobs (md);
+    }));
+    report (s.name, "  contours_pic (lazy)", measure (n, [&](size_t) {
+        md_bench::render_contours (md);
+    }));
+    report (s.name, "cv absdiff/thr/count", measure (n, [&](size_t i) {    // Referenz: 3 Durchläufe
+        cv::Mat diff;
+        cv::absdiff (s.pyr2[i], s.pyr2[(i + 1) % n], diff);
+        cv::threshold (diff, diff, md.properties.threshold, 255, cv::THRESH_TOZERO);
+        volatile int nz = cv::countNonZero (diff);
+        (void)nz;
+    }));
+    report (s.name, "pixdiff::count", measure (n, [&](size_t i) {
+        volatile int nz = pixdiff::count (s.pyr2[i], s.pyr2[(i + 1) % n], (uint8_t)md.properties.threshold);
+        (void)nz;
+    }));
+    const int bg_modes[] = { BG_MEAN, BG_GAUSS };
+    for (int mode : bg_modes) {             // pixdiff::count + Hintergrundmodell in einem Durchlauf
+        bg_model bg;
+        bg.set_mode (mode);
+        report (s.name, (mode == BG_GAUSS) ? "bg_model::update gauss" : "bg_model::update mean", measure (n, [&](size_t i) {
+            volatile int nz = bg.update (s.pyr2[i], &s.pyr2[(i + 1) % n], (uint8_t)md.properties.threshold);
+            (void)nz;
+        }));
+    }
+    const int grids[][2] = { {8, 6}, {16, 12}, {32, 24}, {12, 9} };      // 12x9: nicht spezialisiert
+    for (const auto &g : grids) {
+        char stage[64];
+        sprintf (stage, "pixdiff::tiles %ix%i", g[0], g[1]);
+        std::vector<int> counts (g[0] * g[1]);
+        report (s.name, stage, measure (n, [&](size_t i) {
+            pixdiff::tiles (s.pyr1[i], s.pyr1[(i + 1) % n], g[0], g[1], (uint8_t)md.properties.threshold, counts.data());
+        }));
+    }
+    verify_pixdiff (s, (uint8_t)md.properties.threshold);
+    scale_tiles (s, (uint8_t)md.properties.threshold);
+
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    struct _bench_result_ r_frame = measure (n, [&](size_t i) {
+        md.feed (s.bgr[i], tv);
+    });
+    report (s.name, "get_frame (gesamt)", r_frame);
+
+    // ---- Leerlauf mit Pre-Roll (Default): jedes ausgewertete Bild geht auch in den Pre-Roll ----
+    md.sv.set_preroll (SV_PREROLL_TIME, SV_PREROLL_MEM);
+    long long k = 0;
+    struct _bench_result_ r_pre = measure (n, [&](size_t i) {
+        struct timeval t = tv;
+        t.tv_sec += (time_t)(k / 10);               // 10 fps, Zeitstempel steigend
+        t.tv_usec = (suseconds_t)(k++ % 10) * 100000;
+        md.sv.buffer (md.make_ausgabe_screen (s.bgr[i], md.get_contours_pic()), &t, "1234 pix");
+    });
+    md.sv.set_preroll (0, 0);
+    report (s.name, "pre-roll: record_image + buffer", r_pre);
+    cout << left << setw(20) << s.name << "idle mit Pre-Roll: " << fixed << setprecision(0) << r_frame.ns + r_pre.ns
+         << " ns/frame ausgewertet, " << r_skip.ns / 2 << " ns/frame übersprungen (--skip)" << right << endl;
+    compare_morph (s);
+#ifndef NDEBUG
+    cout << left << setw(20) << s.name << "frame_ctx: " << md.get_ctx_allocs() << " Puffer nach dem Aufwärmen neu angelegt" << right << endl;
+#endif
+
+    report (s.name, "make_ausgabe_screen", measure (n, [&](size_t i) {
+        cv::Mat out = md.make_ausgabe_screen (s.bgr[i], md.get_contours_pic());
+    }));
+
+    // ---- Textzeile im Video: cv::putText() gegen den Cache in write_date_to_pic() ----
+    cv::Mat txt = s.bgr[0].clone();
+    time_t t_now = tv.tv_sec;
+    report (s.name, "putText (Referenz)", measure (n, [&](size_t i) {
+        char buf[512];
+        struct tm t;
+        time_t sec = t_now + (time_t)(i / 10);      // neue Sekunde alle 10 Bilder
+        localtime_r (&sec, &t);
+        sprintf (buf, "%i / %02i.%02i.%i | %02i:%02i:%02i | %s", (int)i, t.tm_mday, t.tm_mon+1, t.tm_year+1900,
+                 t.tm_hour, t.tm_min, t.tm_sec, "1234 pix");
+        cv::putText (txt, buf, cv::Point(10, 20), cv::FONT_HERSHEY_PLAIN, 1.0, CV_RGB(118, 185, 0), 2);
+    }));
+    report (s.name, "write_date_to_pic", measure (n, [&](size_t i) {
+        time_t sec = t_now + (time_t)(i / 10);
+        md.sv.write_date_to_pic (txt, &sec, "1234 pix");
+    }));
+
+    // ---- save_video::write: synchron, ohne Warteschlange ----
+    cv::Mat screen = md.make_ausgabe_screen (s.bgr[0], md.get_contours_pic());
+    if (md.sv.open ("/tmp/lookat_bench.avi", screen.cols, screen.rows)) {
+        char text[] = "bench";
+        std::vector<cv::Mat> screens;
+        for (size_t i=0; i<n; i++)
+            screens.push_back (md.make_ausgabe_screen (s.bgr[i], md.get_contours_pic()));
+        report (s.name, "save_video::write", measure (n, [&](size_t i) {
+            md.sv.write (screens[i], NULL, text);     // ohne Zeitstempel: jedes Bild wird geschrieben
+        }));
+        md.sv.close ();
+        remove ("/tmp/lookat_bench.avi");
+    } else
+        cout << "ERROR save_video::open /tmp/lookat_bench.avi\n";
+}
+
+/*! ----------------------------------------------
+ * @brief Ausgabe der Optionen.
+ */
+static void help ()
+{
+    cout << "Usage: ./lookat_bench [options]\n";
+    cout << "Options:\n";
+    cout << "  -h --help            Print this help screen\n";
+    cout << "  --input <arg>        zusätzlich aufgezeichnete Bilder: Video-Datei oder Verzeichnis\n";
+    cout << "  --iter <arg>         Durchläufe über alle Bilder; default: " << BENCH_ITER << endl;
+    cout << "  --cvthreads <arg>    cv::setNumThreads(); default: OpenCV default\n";
+}
+
+/*! ------------------------------------------------------------
+ *
+ */
+int main (int argc, char ** argv)
+{
+    static const struct option long_options[] = {
+        { "help", no_argument, 0, 'h' },
+        { "input", required_argument, 0, 0 },
+        { "iter", required_argument, 0, 0 },
+        { "cvthreads", required_argument, 0, 0 },
+        { 0, 0, 0, 0 }
+    };
+    std::string input_path;
+
+    while (1) {
+        int index = -1;
+        int result = getopt_long (argc, argv, "h", long_options, &index);
+        if (result == -1)
+            break;
+        if (result == 'h') {
+            help ();
+            return 0;
+        }
+        if ((result != 0) || (index < 0))
+            continue;
+
+        const char *name = long_options[index].name;
+        try {
+            if (strcmp (name, "input") == 0)
+                input_path = optarg;
+            else if (strcmp (name, "iter") == 0)
+                iter = std::max (1, std::stoi (optarg));
+            else if (strcmp (name, "cvthreads") == 0)
+                cv::setNumThreads (std::stoi (optarg));
+        } catch (std::invalid_argument const& ex) {
+            std::cout << "--" << name << " ERROR " << "#1: " << ex.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(800, 800), cv::Size(1920, 1080) };
+
+    std::vector<cv::Mat> rec;
+    if (!input_path.empty())
+        rec = load_recorded (input_path);
+
+    cout << "pixdiff: " << pixdiff::simd_name() << ", morph: " << morph::simd_name() << endl;
+    cout << left << setw(20) << "set" << setw(24) << "stage" << right
+         << setw(14) << "ns/frame" << setw(14) << "bytes/frame" << setw(10) << "allocs" << endl;
+
+    for (const cv::Size &size : sizes) {
+        char name[64];
+
+        struct _bench_set_ syn;
+        sprintf (name, "%ix%i synth", size.width, size.height);
+        syn.name = name;
+        make_synthetic (syn, size);
+        run_set (syn);
+
+        struct _bench_set_ r;
+        sprintf (name, "%ix%i rec", size.width, size.height);
+        r.name = name;
+        if (make_recorded (r, rec, size))
+            run_set (r);
+    }
+
+    return 0;
+}
+
+//! @} bench
@@ -0,0 +1,108 @@
+/*! ------------------------------------------
+ * @addtogroup bg_model
+ * @{
+ *
+ * @file    bg_model.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref bg_model.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include "bg_model.hpp"
+#include "pixdiff.hpp"
+
+/*! ----------------------------------------------
+ * @brief Eine Zeile: Vordergrund bestimmen und das Modell nachführen.
+ * @param p Pixel des aktuellen Bildes
+ * @param m Mittelwert, Festkomma 8.8
+ * @param v Varianz in Graustufen². Wird bei BG_MEAN nicht verwendet.
+ * @param f Vordergrund-Maske
+ * @param thr BG_MEAN: Schwelle für |p - m|
+ * @return Anzahl Vordergrund-Pixel
+ */
+int bg_model::update_row (const uint8_t *p, uint16_t *m, uint16_t *v, uint8_t *f, int n, uint8_t thr)
+{
+    int cnt = 0;
+
+    for (int i=0; i<n; i++) {
+        const int d = (int)p[i] - ((m[i] + 128) >> 8);
+        const int d2 = d * d;
+
+        bool front;
+        if (mode == BG_GAUSS)
+            front = d2 > BG_K2 * ((v[i] > BG_MIN_VAR) ? v[i] : BG_MIN_VAR);
+        else
+            front = d2 > (int)thr * thr;
+        f[i] = (front) ? 255 : 0;
+        cnt += front;
+
+        const int s = (front) ? BG_FG_SHIFT : BG_SHIFT;
+        m[i] = (uint16_t)(m[i] + ((((int)p[i] << 8) - (int)m[i]) >> s));   // m += (p - m) / 2^s
+        if (mode == BG_GAUSS)
+            v[i] = (uint16_t)(v[i] + ((d2 - (int)v[i]) >> s));              // v += (d² - v) / 2^s
+    }
+    return cnt;
+}
+
+/*! ----------------------------------------------
+ * @brief Neues Bild: Differenz zum Vorgängerbild zählen und das Hintergrundmodell nachführen.\n
+ *        Beides geschieht zeilenweise in einem Durchlauf über cur. Bei neuer Bildgrösse beginnt das Modell neu.
+ * @param cur aktuelles Graubild (CV_8UC1), z.B. in[first_in]
+ * @param prev Vorgängerbild gleicher Grösse oder NULL. NULL: es wird nur das Modell nachgeführt.
+ * @param thr Schwelle für die Differenz zum Vorgängerbild wie @ref pixdiff::count(). Bei BG_MEAN auch für den Vordergrund.
+ * @param diff Differenzbild zum Vorgängerbild. Wird nur geschrieben, wenn diff != NULL und prev != NULL.
+ * @return Anzahl Pixel mit |cur - prev| > thr. 0, wenn prev == NULL.
+ */
+int bg_model::update (const cv::Mat &cur, const cv::Mat *prev, uint8_t thr, cv::Mat *diff)
+{
+    CV_Assert (cur.type() == CV_8UC1);
+    CV_Assert (prev == NULL || (prev->type() == CV_8UC1 && prev->size() == cur.size()));
+
+    if ((frames == 0) || (mean.size() != cur.size())) {        // neues Modell: Mittelwert = erstes Bild
+        mean.create (cur.rows, cur.cols, CV_16UC1);
+        var.create (cur.rows, cur.cols, CV_16UC1);
+        fg.create (cur.rows, cur.cols, CV_8UC1);
+        for (int y=0; y<cur.rows; y++) {
+            const uint8_t *p = cur.ptr<uint8_t>(y);
+            uint16_t *m = mean.ptr<uint16_t>(y);
+            uint16_t *v = var.ptr<uint16_t>(y);
+            for (int x=0; x<cur.cols; x++) {
+                m[x] = (uint16_t)(p[x] << 8);
+                v[x] = BG_MIN_VAR;
+            }
+        }
+        frames = 0;
+    }
+    if ((diff != NULL) && (prev != NULL))
+        diff->create (cur.rows, cur.cols, CV_8UC1);
+
+    int cnt = 0;
+    fg_count = 0;
+    for (int y=0; y<cur.rows; y++) {
+        const uint8_t *p = cur.ptr<uint8_t>(y);
+        if (prev != NULL)
+            cnt += pixdiff::row (p, prev->ptr<uint8_t>(y), (diff != NULL) ? diff->ptr<uint8_t>(y) : NULL, cur.cols, thr);
+        fg_count += update_row (p, mean.ptr<uint16_t>(y), var.ptr<uint16_t>(y), fg.ptr<uint8_t>(y), cur.cols, thr);
+    }
+    if (frames < BG_WARM)
+        ++frames;
+    return cnt;
+}
+
+/*! ----------------------------------------------
+ * @brief Mittelwert als Graubild, z.B. für die Bildschirmausgabe.
+ */
+void bg_model::get_mean (cv::Mat &dst)
+{
+    dst.create (mean.rows, mean.cols, CV_8UC1);
+    for (int y=0; y<mean.rows; y++) {
+        const uint16_t *m = mean.ptr<uint16_t>(y);
+        uint8_t *d = dst.ptr<uint8_t>(y);
+        for (int x=0; x<mean.cols; x++)
+            d[x] = (uint8_t)((m[x] + 128) >> 8 > 255 ? 255 : (m[x] + 128) >> 8);
+    }
+}
+
+//! @} bg_model
@@ -0,0 +1,63 @@
+/*! ------------------------------------------
+ * @defgroup bg_model Bg_Model: Hintergrundmodell je Pixel
+ * @{
+ *
+ * @file    bg_model.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Laufender Mittelwert (optional mit Varianz) je Pixel, in Festkomma auf der Auflösung von in[].\n
+ * Ersetzt das feste Hintergrundbild (Kopie nach 8 ruhigen Bildern). Das Modell wird in jedem Bild
+ * im selben Durchlauf wie das Differenzbild zum Vorgängerbild nachgeführt. Ergebnis ist eine Vordergrund-Maske
+ * (@ref bg_model::get_fg()) und die Anzahl Vordergrund-Pixel für die Trigger-Logik.\n
+ * Vordergrund-Pixel lernen 16x langsamer; bleibende Änderungen (abgestelltes Fahrzeug, Licht) werden so
+ * nach einigen hundert Bildern Teil des Hintergrunds.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef BG_MODEL_HPP
+#define BG_MODEL_HPP
+
+#include <stdint.h>
+
+#include "opencv2/opencv.hpp"
+
+#define BG_MEAN 0           //!< nur Mittelwert. Vordergrund: |Pixel - Mittelwert| > Schwelle. Option --bgmodel mean
+#define BG_GAUSS 1          //!< Mittelwert und Varianz. Vordergrund: |Pixel - Mittelwert| > 3 Sigma. Option --bgmodel gauss
+
+#define BG_SHIFT 5          //!< Lernrate Hintergrund: 1/32 je Bild
+#define BG_FG_SHIFT 9       //!< Lernrate Vordergrund: 1/512 je Bild
+#define BG_K2 9             //!< BG_GAUSS: Vordergrund, wenn d² > 9 * Varianz (3 Sigma)
+#define BG_MIN_VAR 16       //!< BG_GAUSS: kleinste Varianz (Sigma = 4 Graustufen). Verhindert Fehlalarme bei ganz ruhigen Pixeln.
+#define BG_WARM 8           //!< Das Modell gilt erst nach 8 Bildern
+
+/*! -------------------------------
+ * @brief class für das Hintergrundmodell.
+ */
+class bg_model {
+public:
+    bg_model () {}
+
+    void reset () { frames = 0; fg_count = 0; }
+    void set_mode (int m) { mode = m; }
+    int update (const cv::Mat &cur, const cv::Mat *prev, uint8_t thr, cv::Mat *diff = NULL);
+
+    bool is_ready () { return frames >= BG_WARM; }
+    int get_fg_count () { return fg_count; }
+    const cv::Mat &get_fg () { return fg; }
+    void get_mean (cv::Mat &dst);
+
+private:
+    int update_row (const uint8_t *p, uint16_t *m, uint16_t *v, uint8_t *f, int n, uint8_t thr);
+
+    int mode = BG_GAUSS;        //!< BG_MEAN oder BG_GAUSS
+    cv::Mat mean;               //!< Mittelwert je Pixel, Festkomma 8.8 (CV_16UC1)
+    cv::Mat var;                //!< Varianz je Pixel in Graustufen² (CV_16UC1). Nur BG_GAUSS.
+    cv::Mat fg;                 //!< Vordergrund-Maske des letzten Bildes: 255 = Vordergrund (CV_8UC1)
+    int frames = 0;             //!< Bilder seit dem letzten @ref reset()
+    int fg_count = 0;           //!< Vordergrund-Pixel im letzten Bild
+};
+
+#endif
+
+//! @} bg_model
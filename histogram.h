@@ -19,6 +19,9 @@ Copyright (C) 2016 Robert Laganiere, www.laganiere.name
 #if !defined HISTOGRAM
 #define HISTOGRAM
 
+#include <algorithm>
+#include <cmath>
+
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -31,6 +34,71 @@ class Histogram1D {
 	float hranges[2];        // range of values
     const float* ranges[1];  // pointer to the different value ranges
     int channels[1];         // channel number to be examined
+    int bins[256];           // Histogramm für stretch(image, percentile, result)
+    uchar lut[256];          // LUT für stretch(image, percentile, result)
+    int lutEvery = 1;        // LUT-Cache: neue LUT spätestens nach lutEvery Bildern. @see setLutCache()
+    int lutStep = 1;         // LUT-Cache: nur jede lutStep-te Zeile und Spalte auswerten
+    float lutTolerance = 0;  // LUT-Cache: zulässige Abweichung der mittleren Helligkeit
+    int lutAge = -1;         // Bilder seit der letzten LUT. -1: keine LUT vorhanden
+    float lutMean = 0;       // mittlere Helligkeit beim Berechnen der LUT
+    float lutPercentile = 0; // percentile der LUT
+    long lutCount = 0;       // Anzahl berechneter LUTs
+
+    // Mittlere Helligkeit aus jeder lutStep-ten Zeile und Spalte.
+    float sampleMean(const cv::Mat &image) {
+
+        long sum = 0, n = 0;
+        for (int y = 0; y<image.rows; y += lutStep) {
+            const uchar *p = image.ptr<uchar>(y);
+            for (int x = 0; x<image.cols; x += lutStep)
+                sum += p[x];
+            n += (image.cols + lutStep - 1) / lutStep;
+        }
+        return (n > 0) ? (float)sum / n : 0.0f;
+    }
+
+    // Histogramm aus jeder lutStep-ten Zeile und Spalte, daraus Grenzen und LUT wie in stretch(image, percentile).
+    void makeLut(const cv::Mat &image, float percentile) {
+
+        for (int i = 0; i<256; i++)
+            bins[i] = 0;
+        long n = 0;
+        for (int y = 0; y<image.rows; y += lutStep) {
+            const uchar *p = image.ptr<uchar>(y);
+            for (int x = 0; x<image.cols; x += lutStep)
+                ++bins[p[x]];
+            n += (image.cols + lutStep - 1) / lutStep;
+        }
+
+        // number of pixels in percentile
+        float number= n*percentile;
+
+        int imin = 0;
+        for (float count=0.0; imin < 256; imin++) {
+            if ((count += bins[imin]) >= number)
+                break;
+        }
+        int imax = 255;
+        for (float count=0.0; imax >= 0; imax--) {
+            if ((count += bins[imax]) >= number)
+                break;
+        }
+
+        for (int i = 0; i<256; i++) {
+
+            if (i < imin) lut[i] = 0;
+            else if (i > imax) lut[i] = 255;
+            else lut[i] = (imax > imin) ? cvRound(255.0*(i - imin) / (imax - imin)) : 0;
+        }
+
+        long sum = 0;
+        for (int i = 0; i<256; i++)
+            sum += (long)i * bins[i];
+        lutMean = (n > 0) ? (float)sum / n : 0.0f;
+        lutPercentile = percentile;
+        lutAge = 0;
+        ++lutCount;
+    }
 
   public:
 
@@ -204,6 +272,63 @@ class Histogram1D {
         return result;
     }
 
+    /*! ------------------------------------------------------------------
+     * @brief LUT-Cache für stretch(image, percentile, result) einstellen.\n
+     *        Die Grenzen werden nur alle <every> Bilder neu bestimmt, oder wenn die mittlere Helligkeit
+     *        um mehr als <tolerance> Graustufen abweicht. Sonst wird die LUT des Vorgängers verwendet.
+     *
+     * @param every neue LUT spätestens nach every Bildern. 0 oder 1: jedes Bild, volles Bild (wie bisher).
+     * @param step Histogramm und Helligkeit nur aus jeder step-ten Zeile und Spalte
+     * @param tolerance zulässige Abweichung der mittleren Helligkeit in Graustufen
+     */
+    void setLutCache(int every, int step, float tolerance) {
+
+        if (every <= 1) {
+            every = 1;
+            step = 1;
+        }
+        if ((every != lutEvery) || (step != lutStep) || (tolerance != lutTolerance))
+            lutAge = -1;        // neue Einstellung: LUT neu bestimmen
+        lutEvery = every;
+        lutStep = std::max(1, step);
+        lutTolerance = tolerance;
+    }
+
+    /*! ------------------------------------------------------------------
+     * @brief Wie stretch(image, percentile), aber ohne Allokation im Dauerbetrieb.\n
+     *        Histogramm und LUT liegen im Objekt, result wird nur beim ersten Aufruf
+     *        oder bei geänderter Bildgrösse angelegt. Nur für CV_8UC1 mit 256 Bins.\n
+     *        Mit setLutCache() wird die LUT nur bei Bedarf neu berechnet.
+     *
+     * @param image Graubild CV_8UC1
+     * @param percentile Anteil der Pixel, die links und rechts abgeschnitten werden
+     * @param result Ergebnis. Darf nicht image sein.
+     */
+    void stretch(const cv::Mat &image, float percentile, cv::Mat &result) {
+
+        CV_Assert(image.type() == CV_8UC1 && result.data != image.data);
+
+        bool renew = (lutAge < 0) || (lutEvery <= 1) || (++lutAge >= lutEvery) || (percentile != lutPercentile);
+        if (!renew && (fabs(sampleMean(image) - lutMean) > lutTolerance))
+            renew = true;       // Helligkeit hat sich geändert
+        if (renew)
+            makeLut(image, percentile);
+
+        result.create(image.rows, image.cols, CV_8UC1);
+        for (int y = 0; y<image.rows; y++) {
+            const uchar *p = image.ptr<uchar>(y);
+            uchar *q = result.ptr<uchar>(y);
+            for (int x = 0; x<image.cols; x++)
+                q[x] = lut[p[x]];
+        }
+    }
+
+    // Anzahl neu berechneter LUTs seit dem Start. Zur Kontrolle des LUT-Cache.
+    long getLutCount() {
+
+        return lutCount;
+    }
+
     /*! ------------------------------------------------------------------
      * @brief Es werden die 3 Channel von src gestretcht.
      * 
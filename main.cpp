@@ -36,21 +36,46 @@ Usage: ./lookat [options]\n
 Options:\n
   -h --help            Print this help screen \n
   -e --threshold <arg> Schwellwert; default: 64 \n
-  -c --cam <arg>       Kamera-Nr; default: 0. Verfügbare Kameras lassen sich mit ls /dev/video* anzeigen. \n
+  -c --cam <arg>       Kamera-Nr; default: 0. Verfügbare Kameras lassen sich mit ls /dev/video* anzeigen. Mehrfach: mehrere Kameras \n
   -m --manuell         Start/Stop prozess with key 'm' \n
   -n --noutput         keine Bildschirmausgabe \n
   -d --diff <arg>      Pixel-Differenz zum Vorgängerbild [1..5000]; default: 5 \n
   -g --gray            Save grayscale \n
-  -a --trail <arg>     Nachlauf in frames; default: 7 \n
+  -a --trail <arg>     Nachlauf in frames bei --fps; default: 7 \n
   -p --picture         save only picture \n
   -w --camwidth <arg>  Kamerabild Breite; default: 640 \n
   -i --camheight <arg> Kamerabild Höhe; default: 480 \n
 \n
   --pixdiff <arg>      Pixel-Differenz[0..5000] für Mosaik-Segment; default: 25 \n
+  --grid <WxH>         Mosaik-Auflösung [1..64]x[1..64]; default: 8x6 \n
+  --lutcache <arg>     Stretch-LUT nur alle n Bilder neu berechnen [0..1000], 0 = jedes Bild; default: 10 \n
+  --fastpre            Schnelle Vorverarbeitung: Grau, ROI und Verkleinerung in einem Durchlauf \n
+  --morph <arg>        dilate/erode: vhgw | cv; default: vhgw \n
+  --pixfmt <arg>       Kamera-Format: bgr | yuyv | mjpg. yuyv, mjpg: BGR nur für Anzeige und Video; default: bgr \n
+  --capture <arg>      Bildeinzug: cv | v4l2. v4l2: MMAP-Puffer ohne Kopie, Zeitstempel vom Kernel; default: cv \n
+  --v4l2bufs <arg>     Anzahl Treiberpuffer bei --capture v4l2 [6..32]; default: 8 \n
+  --fps <arg>          Ziel-Framerate der Auswertung [1..60]; default: 10 \n
+  --idlefps <arg>      Framerate bei ruhigem Bild [0..60], 0 = aus; default: 2 \n
+  --threads <arg>      Mosaik-Felder parallel zählen [0..16], 1 = seriell, 0 = alle Threads von OpenCV; default: 1 \n
+  --bgmodel <arg>      Hintergrundmodell: gauss | mean. gauss: Mittelwert und Varianz je Pixel; default: gauss \n
+  --skip <arg>         Vorfilter: max. übersprungene Bilder in Folge (höchstens 1 s) bei unverändertem Vorschaubild [0..100], 0 = aus; default: 10 \n
   --minvidtime <arg>   Min.Videolänge in [ms]; default: 2700 ms. kleinster Wert ist 2000 ms. \n
   --maxvidtime <arg>   Max.Videolänge in [ms]; default: 20000 ms. \n
   --maxvideo <arg>     Max.Anzahl Video's; default -1, d.h keine Begrenzung \n
   --vidpath <arg>      Pfad zum Sichern der Videos; default: ~/lookat_video/DATUM \n
+  --vidqueue <arg>     Video-Warteschlange in Bildern, 0 = synchron; default: 8 \n
+  --vidpolicy <arg>    Warteschlange voll: drop | block; default: drop \n
+  --codec <arg>        Video-Encoder: auto | v4l2m2m | x264 | ffmpeg | mjpg. auto: H.264, wenn vorhanden; default: auto \n
+  --container <arg>    Container für H.264: auto | mkv | mp4 | avi. MJPG immer avi; default: auto (mkv) \n
+  --bitrate <arg>      H.264-Bitrate in [kbit/s] [100..20000]; default: 2000 \n
+  --gop <arg>          H.264: Abstand der Keyframes in Bildern [1..300]; default: 50 \n
+  --quota <arg>        Max. Platz aller Videos und Bilder in [MB], 0 = keine Grenze; default: 0 \n
+  --minfree <arg>      Min. freier Platz im Video-Verzeichnis in [MB], 0 = keine Grenze; default: 0 \n
+  --record <arg>       Video-Inhalt: composite | raw. raw: nur Kamerabild, Text als Untertitel (.vtt); default: composite \n
+  --preroll <arg>      Aufnahme vor dem Auslösen in [ms], 0 = aus; default: 2000 ms \n
+  --prerollmem <arg>   Max. Speicher für den Pre-Roll in [kB]; default: 16384 kB \n
+  --input <arg>        Replay: Video-Datei oder Verzeichnis mit Bildern statt Kamera \n
+  --csv <arg>          Protokoll je Bild als CSV-Datei \n
 \n
 ------ Sensitiver Bildausschnitt ------ \n
   -l --left <arg>       left roi \n
@@ -72,20 +97,10 @@ Options:\n
 \n
 @code
 ./lookat --camwidth 800 --camheight 600 -l 50 -r 750 -t 150 -b 400 --maxvideo 50
+./lookat --input test.avi --csv test.csv --noutput
 @endcode
  */
 
-// -------- define for developer -------
-#define USE_HARRIS_DETECTOR_        //!< Versuch: Über die Anzahl der Punkte eine Bewegung erkennen.
-#define USE_FEATURE_DETECTOR_
-
-#ifdef USE_FEATURE_DETECTOR
-    #define USE_HARRIS_DETECTOR
-#endif
-
-#define SHOW_MOSAIK_                //!< SHOW_MOSAIK zeigt ein screen mit dem Mosiak.
-#define SHOW_HISTOGRAM_             //!< SHOW_HISTOGRAM zeigt das original und gestretchte Histogram.
-// -------------------------------------
 #define RASPI_
 
 #include <iostream>
@@ -99,6 +114,7 @@ Options:\n
 #endif
 
 #include <cstdint>
+#include <cstring>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdio.h>
@@ -107,116 +123,48 @@ Options:\n
 #include <fcntl.h>
 #include <unistd.h>
 #include <cassert>
-#include "timefunc.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include "version.h"
 
 #ifdef RASPI
     #include "raspi.hpp"
 #endif
 
-#include "Save_Vid.hpp"
-#include "histogram.h"
-#ifdef USE_HARRIS_DETECTOR
-    #include "harrisDetector.h"
-#endif
+#include "MotionDetector.hpp"
+#include "timefunc.hpp"
+#include "worker_pool.hpp"
+#include "sv_encoder.hpp"
+#include "storage.hpp"
 
 #include "opencv2/opencv.hpp"
 
-// #define USE_CVD      //!< used by OpenCVD @see https://github.com/ubuettemeier/OpenCVD
-
-#ifdef USE_CVD
-    #include "../../OpenCVD/include/opencvd.hpp"
-    #include "../../OpenCVD/include/specdef.hpp"
-#else 
-    #define CVD cv
-#endif
-
 using namespace std;
 using namespace cv;
 
-#define MAX_IN 3                //!< Anzahl matrices für input-Screen. @ref in[], @ref src[]
-#define HORZ_TEILER 8           //!< Horizontale Auflösung für Mosaikbilder. @ref seg[], @ref seg_diff[], @ref seg_NonZero[]
-#define VERT_TEILER 6           //!< Vertikale Auflösung für Mosaikbilder. @ref seg[], @ref seg_diff[], @ref seg_NonZero[]
-#define MAX_DELAY 100000        //!< Verweilzeit in [us] für @ref get_frame().
+#define MAX_CAMS 4              //!< Max. Anzahl Kameras je Prozess. Option --cam mehrfach
 
-cv::Mat src[MAX_IN];            //!< ROI Ringpuffer von @ref src_image
-cv::Mat in[MAX_IN];             //!< gray Image Ringpuffer von @ref src[]
-cv::Mat src_image;              //!< Input Image
-
-cv::Mat seg[MAX_IN][HORZ_TEILER][VERT_TEILER];              //!< Mosaik-Bild z.B.:  640 x 480 => 80 x 80
-cv::Mat seg_diff[HORZ_TEILER][VERT_TEILER];                 //!< Mosaik Differenzbild
-cv::Mat seg_NonZero (VERT_TEILER, HORZ_TEILER, CV_8UC1);    //!< Mosaik-Matrix
-cv::Mat contours_pic;                                       //!< Contour-Bild
 int camwidth = 640;                                         //!< Defaultwert für Parameter --camwidth.
 int camheight = 480;                                        //!< Defaultwert für Parameter --camheight.
-int contour_x_center = 0;                                   //!< Konturschwerpunkt in X
-#ifdef SHOW_MOSAIK
-    cv::Mat show_seg;                           // Ausgabebild für Mosaik
-#endif
-
-cv::Mat diff, back;                         //!< Differenzbild, Hintergrundbild
-uint8_t first_in = 0, last_in = MAX_IN-1;   //!< Ringzähler
-int anz_zero[MAX_IN] = {-1};                //!< Speicher für NonZero-Werte
-time_t now[MAX_IN];                         //!< Aufnahme-Zeitpunkt
-int anz_sensetive_pixel = 0;                //!< Anzahl der senetiven Pixel. Wird berechnet in @ref get_anzahl_sensetive_pixel()
-
-cv::VideoCapture cap;           //!< Kamera Konstructor. Gestartet wird die Kamera mit <cap.open()>
-save_video sv;                  //!< class {@ref Save_Vid.hpp} initialisieren
-
-#ifdef USE_HARRIS_DETECTOR
-    cv::Mat harrisCorners;
-    HarrisDetector harris;
-#endif
 
-#ifdef USE_FEATURE_DETECTOR
-    // cv::Ptr<cv::FeatureDetector> detector = cv::FastFeatureDetector::create(0);
-    cv::Ptr<cv::FeatureDetector> detector = cv::FastFeatureDetector::create(25, false, FastFeatureDetector::TYPE_7_12);
-    cv::Ptr<cv::DescriptorExtractor> descriptor;
-    std::vector<cv::KeyPoint> pyrKeypoints;
-#endif
+frame_grabber grabber;          //!< Bildeinzug im eigenen Thread. Geöffnet wird die Kamera mit <grabber.open()>
+storage store;                  //!< Index aller Videos, Quota und Freiplatz. Wird nach md abgebaut. @see storage::open()
+MotionDetector md;              //!< Bewegungserkennung. Enthält properties, geo, ignor_geo und save_video.
+struct _geo_ new_geo = {-1, -1, -1, -1};    //!< Sensitiver Bildausschnitt aus den Optionen --left, --top, --right, --bottom
+std::string input_path;         //!< Replay: Video-Datei oder Verzeichnis. Option --input
+int pixfmt = PIXFMT_BGR;        //!< Pixelformat der Kamera. Option --pixfmt
+int capture = CAPTURE_CV;       //!< Bildeinzug mit cv::VideoCapture oder v4l2_capture. Option --capture
+int v4l2_bufs = V4L2_BUFS;      //!< Anzahl Treiberpuffer bei --capture v4l2. Option --v4l2bufs
+std::string csv_path;           //!< Protokoll je Bild. Option --csv
+struct _sv_codec_ codec;        //!< Video-Encoder. Optionen --codec, --container, --bitrate, --gop. @see sv_encoder::probe()
+long long quota_mb = ST_QUOTA;      //!< Max. Platz aller Dateien in [MB]. Option --quota
+long long minfree_mb = ST_MINFREE;  //!< Min. freier Platz in [MB]. Option --minfree
+std::string video_root;         //!< Video-Verzeichnis ohne Datum, z.B. ~/lookat_video. @see init_folder()
+std::vector<int> cams;          //!< Kamera-Nr. aus --cam. Mehrfach angegeben: eine Pipeline je Kamera. @see run_cameras()
 
 #pragma pack(1)
 
-/*! ---------------------------------------------------------------
- * @brief Diverse Parameter
- */
-struct _properties_ {
-    int cam_index = 0;          //!< Kann mit Parameter --cam geändert werden.
-    int threshold = 64;         //!< Alle Pixel in diff unter 64 werden auf 0 gesetzt. @see @ref schwelle()
-    int diff_non_zero = 0;      //!< Enthält die aktuelle NonZero Differenz von last_in - first_in. 
-    int video_start_diff = 5;   //!< sobald @ref diff_non_zero >= video_start_diff ist, wird eine Aufnahme gestartet! Wertebereich: [1...5000]. See: @ref control(). Das Flag @ref falle_aktiv wird auf TRUE gesetzt!
-    bool falle_aktiv = false;   //!< Flag zeigt an, ob eine Bewegung erkannt wurde. @ref get_frame().
-    int trail = 7;              //!< Nachlauf in frames. ca.1200 ms
-    bool run = true;            //!< Überwachung aktiv / inaktiv
-    bool no_output = false;     //!< bei true wird kein Camerabild gezeigt. Wird mit der Option --noutput gesetzt.
-    int frame_delay = MAX_DELAY;    //!< Verweilzeit in [us] für @ref get_frame().
-    int NonZero_seg = 25;       //!< pixdiff für Mosaik. Lässt sich mit der Option --pixdiff ändern.
-    int min_time = 2700;        //!< Min.Videolänge in [ms]. Kleinster zulässiger Wert ist 2000 ms
-    int max_time = 20000;       //!< Max.Videolänge in [ms].
-    bool only_picture = false;  //!< Bei true werden nur Bilder gespeichert, kein Videos. Wird mit der Option --picture eingeschaltet.
-    std::string vidpath;        //!< Pfad zum Sichern der Bewegungs-Videos; default: ~/lookat_video/DATUM
-} properties;
-
-/*! ----------------------------------------------------------------------
- * @brief Sensitiver Bildausschnitt
- */
-struct _geo_ {
-    int left = 0;
-    int top = 0;
-    int right = 639;        //!< if (cam_para.fwidth > geo.width) geo.width = cam_para.fwidth;
-    int bottom = 479;       //!< if (cam_para.fheight > geo.height) geo.height = cam_para.fheight;
-} geo, new_geo = {-1, -1, -1, -1};
-
-/*! ----------------------------------------------------------------------
- * @brief Ignorierter Bildausschnitt
- */
-struct _ignor_geo_ {
-    int ignorleft = 0;
-    int ignortop = 0;
-    int ignorwidth = 0;
-    int ignorheight = 0;
-} ignor_geo;
-
 /*! ------------------ --------------------------------------------
  * @brief Camera Parameter
  */
@@ -231,9 +179,26 @@ struct _cam_para_ {
 
 #pragma pack()
 
-uint16_t state = 0;             //!< wird in @ref control() verwendet
-int vid_counter = 0;
-std::string folder;             //!< Ausgabeverzeichnis; default: ~/lookat_video/DATUM  kann mit der Option --vidpath eingestellt werden.
+/*! ------------------ --------------------------------------------
+ * @brief Eine Kamera bei mehreren --cam Optionen: eigener Bildeinzug, eigene state-machine, eigenes save_video.\n
+ *        md gehört dem Auftrag im @ref worker_pool. Der Haupt-Thread liest nur die atomaren Werte.
+ */
+struct _camera_ {
+    int cam_index = 0;                  //!< Kamera-Nr
+    frame_grabber grabber;              //!< Bildeinzug
+    MotionDetector md;                  //!< Bewegungserkennung mit eigenem save_video
+    bool ready = false;                 //!< genug Bilder, check_pixdiff() und anz_sensetive_pixel erledigt
+    std::atomic<bool> run {true};       //!< Überwachung aktiv. Taste 'm'. Wird vor control() übernommen.
+    std::atomic<uint64_t> frames {0};   //!< ausgewertete Bilder
+    std::atomic<int> videos {0};        //!< Nr. des nächsten Videos
+    std::atomic<bool> idle {false};     //!< Auswertung mit --idlefps
+};
+
+struct _camera_ cameras[MAX_CAMS];      //!< Pipelines bei mehreren Kameras. Statisch, da frame_grabber auf 64 Byte ausgerichtet ist.
+int anz_cameras = 0;                    //!< belegte Einträge in cameras[]
+worker_pool pool;                       //!< gemeinsame Threads für alle Kameras. @see run_cameras()
+std::atomic<bool> cams_ende (false);    //!< true: Aufträge der Kameras nicht mehr neu einstellen
+
 std::string home_dir;           //!< Home Verzeichnis @see {@ref get_homedir()}
 
  // Variablen werden für kbhit() und getch() benötigt
@@ -250,28 +215,19 @@ int control_opt (int argc, char ** argv);
 void show_properties ();
 
 static void show_geo ();
-static void reset_geo ();
 
 void init_keyboard ();
 void close_keyboard ();
 int getch ();
 int kbhit ();
 
-inline bool file_exists (const std::string& name);
-void init_vid_counter ();
 int make_path (std::string pname);
 int init_folder ();
 
-cv::Mat make_ausgabe_screen (cv::Mat src, cv::Mat seg_screen);
-void make_seg (cv::Mat src);
-void write_diff_non_zero_to_diff ();
-int check_pixdiff ();
-int get_anzahl_sensetive_pixel ();
-void get_frame ();
-
-static void control ();
-static void get_cam_para ();
+static bool open_camera (frame_grabber &g, int cam_index, int &fmt);
+static void get_cam_para (frame_grabber &g);
 static void show_cam_para ();
+static int run_cameras ();
 
 /*! --------------------------------------------------------------
  * @brief Ausgabe der Kameraparameter.
@@ -279,15 +235,43 @@ static void show_cam_para ();
 void show_properties ()
 {
     cout << "-------- properties ---------\n";
-    cout << "--threshold   " << properties.threshold << endl;
-    cout << "--cam         " << properties.cam_index << endl;
-    cout << "--diff        " << properties.video_start_diff << endl;
-    cout << "--trail       " << properties.trail << endl;
-    cout << "--pixdiff     " << properties.NonZero_seg << endl;
-    cout << "--minvidtime  " << properties.min_time << " ms\n";
-    cout << "--maxvidtime  " << properties.max_time << " ms\n";
-    cout << "--vidpath     " << properties.vidpath << endl;
-    cout << "--frame_delay " << properties.frame_delay/1000 << " ms\n";
+    cout << "--threshold   " << md.properties.threshold << endl;
+    cout << "--cam         ";
+    for (size_t i=0; i<cams.size(); i++)
+        cout << ((i > 0) ? ", " : "") << cams[i];
+    cout << ((cams.empty()) ? std::to_string (md.properties.cam_index) : "") << endl;
+    cout << "--diff        " << md.properties.video_start_diff << endl;
+    cout << "--trail       " << md.properties.trail << endl;
+    cout << "--pixdiff     " << md.properties.NonZero_seg << endl;
+    cout << "--grid        " << md.properties.grid_x << "x" << md.properties.grid_y << endl;
+    cout << "--lutcache    " << md.properties.lut_cache << endl;
+    cout << "--fastpre     " << ((md.properties.fast_pre) ? "on" : "off") << endl;
+    cout << "--morph       " << ((md.properties.morph == MORPH_VHGW) ? "vhgw" : "cv") << endl;
+    cout << "--pixfmt      " << ((pixfmt == PIXFMT_YUYV) ? "yuyv" : (pixfmt == PIXFMT_MJPG) ? "mjpg" : "bgr") << endl;
+    cout << "--capture     " << ((capture == CAPTURE_V4L2) ? "v4l2" : "cv") << endl;
+    cout << "--v4l2bufs    " << v4l2_bufs << endl;
+    cout << "--fps         " << md.properties.fps << endl;
+    cout << "--idlefps     " << md.properties.idle_fps << ((md.is_idle()) ? " (idle)" : "") << endl;
+    cout << "--threads     " << md.properties.threads << endl;
+    cout << "--bgmodel     " << ((md.properties.bg_mode == BG_GAUSS) ? "gauss" : "mean") << endl;
+    cout << "--skip        " << md.properties.skip_max << " (" << md.get_skipped() << " Bilder übersprungen)" << endl;
+    cout << "--minvidtime  " << md.properties.min_time << " ms\n";
+    cout << "--maxvidtime  " << md.properties.max_time << " ms\n";
+    cout << "--vidpath     " << md.properties.vidpath << endl;
+    cout << "--vidqueue    " << md.properties.vid_queue << endl;
+    cout << "--vidpolicy   " << ((md.properties.vid_policy == SV_DROP) ? "drop" : "block") << endl;
+    cout << "--codec       " << sv_encoder::name (codec.backend) << endl;
+    cout << "--container   " << ((codec.container == SV_CONT_AUTO) ? "auto" : sv_encoder::ext (codec.container)) << endl;
+    cout << "--bitrate     " << codec.bitrate << " kbit/s\n";
+    cout << "--gop         " << codec.gop << endl;
+    cout << "--quota       " << quota_mb << " MB\n";
+    cout << "--minfree     " << minfree_mb << " MB\n";
+    cout << "--record      " << ((md.properties.record == RECORD_RAW) ? "raw" : "composite") << endl;
+    cout << "--preroll     " << md.properties.preroll << " ms\n";
+    cout << "--prerollmem  " << md.properties.preroll_mem << " kB\n";
+    cout << "--input       " << input_path << endl;
+    cout << "--csv         " << csv_path << endl;
+    cout << "--frame_delay " << md.properties.frame_delay/1000 << " ms\n";
 }
 
 /*! --------------------------------------------------------------
@@ -301,22 +285,47 @@ static void help()
     cout << "Usage: ./lookat [options]\n";
     cout << "Options:\n";
     cout << "  -h --help            Print this help screen\n";
-    cout << "  -e --threshold <arg> Schwellwert; default: " << properties.threshold << endl;
-    cout << "  -c --cam <arg>       Kamera-Nr; default: " << properties.cam_index << ". Verfügbare Kameras lassen sich mit ls /dev/video* anzeigen." << endl;
+    cout << "  -e --threshold <arg> Schwellwert; default: " << md.properties.threshold << endl;
+    cout << "  -c --cam <arg>       Kamera-Nr; default: " << md.properties.cam_index << ". Verfügbare Kameras lassen sich mit ls /dev/video* anzeigen. Mehrfach: mehrere Kameras" << endl;
     cout << "  -m --manuell         Start/Stop prozess with key 'm'\n";
     cout << "  -n --noutput         keine Bildschirmausgabe\n";
-    cout << "  -d --diff <arg>      Pixel-Differenz zum Vorgängerbild [1..5000]; default: " << properties.video_start_diff << endl;
+    cout << "  -d --diff <arg>      Pixel-Differenz zum Vorgängerbild [1..5000]; default: " << md.properties.video_start_diff << endl;
     cout << "  -g --gray            Save grayscale\n";
-    cout << "  -a --trail <arg>     Nachlauf in frames; default: " << properties.trail << endl;
+    cout << "  -a --trail <arg>     Nachlauf in frames bei --fps; default: " << md.properties.trail << endl;
     cout << "  -p --picture         save only picture\n";
     cout << "  -w --camwidth <arg>  Kamerabild Breite; default: 640\n";
     cout << "  -i --camheight <arg> Kamerabild Höhe; default: 480\n";
     cout << endl;
-    cout << "  --pixdiff <arg>      Pixel-Differenz[0..5000] für Mosaik-Segment; default: " << properties.NonZero_seg << endl;
+    cout << "  --pixdiff <arg>      Pixel-Differenz[0..5000] für Mosaik-Segment; default: " << md.properties.NonZero_seg << endl;
+    cout << "  --grid <WxH>         Mosaik-Auflösung [1.." << MAX_TEILER << "]x[1.." << MAX_TEILER << "]; default: " << HORZ_TEILER << "x" << VERT_TEILER << endl;
+    cout << "  --lutcache <arg>     Stretch-LUT nur alle n Bilder neu berechnen [0..1000], 0 = jedes Bild; default: " << LUT_CACHE << endl;
+    cout << "  --fastpre            Schnelle Vorverarbeitung: Grau, ROI und Verkleinerung in einem Durchlauf\n";
+    cout << "  --morph <arg>        dilate/erode: vhgw | cv; default: vhgw\n";
+    cout << "  --pixfmt <arg>       Kamera-Format: bgr | yuyv | mjpg. yuyv, mjpg: BGR nur für Anzeige und Video; default: bgr\n";
+    cout << "  --capture <arg>      Bildeinzug: cv | v4l2. v4l2: MMAP-Puffer ohne Kopie, Zeitstempel vom Kernel; default: cv\n";
+    cout << "  --v4l2bufs <arg>     Anzahl Treiberpuffer bei --capture v4l2 [" << GRAB_RING_SIZE + 2 << "..32]; default: " << V4L2_BUFS << endl;
+    cout << "  --fps <arg>          Ziel-Framerate der Auswertung [1..60]; default: " << FPS_DEFAULT << endl;
+    cout << "  --idlefps <arg>      Framerate bei ruhigem Bild [0..60], 0 = aus; default: " << IDLE_FPS << endl;
+    cout << "  --threads <arg>      Mosaik-Felder parallel zählen [0..16], 1 = seriell, 0 = alle Threads von OpenCV; default: " << TILE_THREADS << endl;
+    cout << "  --bgmodel <arg>      Hintergrundmodell: gauss | mean. gauss: Mittelwert und Varianz je Pixel; default: gauss\n";
+    cout << "  --skip <arg>         Vorfilter: max. übersprungene Bilder in Folge (höchstens 1 s) bei unverändertem Vorschaubild [0..100], 0 = aus; default: " << SKIP_MAX << endl;
     cout << "  --minvidtime <arg>   Min.Videolänge in [ms]; default: 2700 ms. Kleinster Wert ist 2000 ms\n";
     cout << "  --maxvidtime <arg>   Max.Videolänge in [ms]; default: 20000 ms\n";
     cout << "  --maxvideo <arg>     Max.Anzahl Video's; default -1, d.h keine Begrenzung\n";
     cout << "  --vidpath <arg>      Pfad zum Sichern der Videos; default: ~/lookat_video/DATUM\n";
+    cout << "  --vidqueue <arg>     Video-Warteschlange in Bildern, 0 = synchron; default: " << SV_QUEUE_DEPTH << endl;
+    cout << "  --vidpolicy <arg>    Warteschlange voll: drop | block; default: drop\n";
+    cout << "  --codec <arg>        Video-Encoder: auto | v4l2m2m | x264 | ffmpeg | mjpg. auto: H.264, wenn vorhanden; default: auto\n";
+    cout << "  --container <arg>    Container für H.264: auto | mkv | mp4 | avi. MJPG immer avi; default: auto (mkv)\n";
+    cout << "  --bitrate <arg>      H.264-Bitrate in [kbit/s] [100..20000]; default: " << SV_BITRATE << endl;
+    cout << "  --gop <arg>          H.264: Abstand der Keyframes in Bildern [1..300]; default: " << SV_GOP << endl;
+    cout << "  --quota <arg>        Max. Platz aller Videos und Bilder in [MB], 0 = keine Grenze; default: " << ST_QUOTA << endl;
+    cout << "  --minfree <arg>      Min. freier Platz im Video-Verzeichnis in [MB], 0 = keine Grenze; default: " << ST_MINFREE << endl;
+    cout << "  --record <arg>       Video-Inhalt: composite | raw. raw: nur Kamerabild, Text als Untertitel (.vtt); default: composite\n";
+    cout << "  --preroll <arg>      Aufnahme vor dem Auslösen in [ms], 0 = aus; default: " << SV_PREROLL_TIME << " ms\n";
+    cout << "  --prerollmem <arg>   Max. Speicher für den Pre-Roll in [kB]; default: " << SV_PREROLL_MEM << " kB\n";
+    cout << "  --input <arg>        Replay: Video-Datei oder Verzeichnis mit Bildern statt Kamera\n";
+    cout << "  --csv <arg>          Protokoll je Bild als CSV-Datei\n";
     cout << endl;
     cout << "------ Sensitiver Bildausschnitt ------\n";
     cout << "  -l --left <arg>      left roi\n";
@@ -373,45 +382,15 @@ static void show_cplus_version ()
 static void show_geo ()
 {
     cout << "------- sensitiver Bildausschnitt ------\n";
-    cout << "  left = " << geo.left << endl;
-    cout << "   top = " << geo.top << endl;
-    cout << " right = " << geo.right << endl;
-    cout << "bottom = " << geo.bottom << endl;
+    cout << "  left = " << md.geo.left << endl;
+    cout << "   top = " << md.geo.top << endl;
+    cout << " right = " << md.geo.right << endl;
+    cout << "bottom = " << md.geo.bottom << endl;
     cout << endl;
-    cout << "  ignorleft = " << ignor_geo.ignorleft << endl;
-    cout << "   ignortop = " << ignor_geo.ignortop << endl;
-    cout << " ignorwidth = " << ignor_geo.ignorwidth << endl;
-    cout << "ignorheight = " << ignor_geo.ignorheight << endl;
-}
-
-/*! ----------------------------------------
- * @brief struct _geo_ wird mit Screen-Abmessung belegt.\n
- *        Es ist wichtig, das im Vorfeld die Funktion {@ref get_cam_para()} aufgerufen wurde!
- */
-static void reset_geo ()
-{
-    geo.left = (new_geo.left >= 0) ? new_geo.left : 0;
-    geo.top = (new_geo.top !=-1) ? new_geo.top : 0;
-    geo.right = (new_geo.right !=-1) ? new_geo.right : cam_para.fwidth-1;
-    geo.bottom = (new_geo.bottom !=-1) ? new_geo.bottom : cam_para.fheight-1;
-
-    // Plausibilitätsprüfung
-    if ((geo.left > cam_para.fwidth-1) || (geo.left >= geo.right)) {
-        cout << "ERROR Parameter --left out of range. --left wird auf 0 gesetzt\n";
-        geo.left = 0;
-    }
-    if ((geo.right > cam_para.fwidth-1) || (geo.right <= geo.left)) {
-        cout << "ERROR Parameter --right out of range. --right wird auf MAX gesetzt\n";
-        geo.right = cam_para.fwidth - 1;
-    }
-    if ((geo.top > cam_para.fheight-1) || (geo.top >= geo.bottom)) {
-        cout << "ERROR Parameter --top out of range. --top wird auf 0 gesetzt\n";
-        geo.top = 0;
-    }
-    if ((geo.bottom > cam_para.fheight-1) || (geo.bottom <= geo.top)) {
-        cout << "ERROR Parameter --bottom out of range. --bottom wird auf MAX gesetzt\n";
-        geo.bottom = cam_para.fheight-1;
-    }
+    cout << "  ignorleft = " << md.ignor_geo.ignorleft << endl;
+    cout << "   ignortop = " << md.ignor_geo.ignortop << endl;
+    cout << " ignorwidth = " << md.ignor_geo.ignorwidth << endl;
+    cout << "ignorheight = " << md.ignor_geo.ignorheight << endl;
 }
 
 /**
@@ -432,12 +411,177 @@ static void check_long_options (struct option *opt, char *optarg)
                 return;
             }
             if ((foo >= 0) && (foo <= 5000)) {          // Plausibilität prüfen
-                properties.NonZero_seg = foo;
-                cout << "pixdeiff = " << properties.NonZero_seg << endl;
+                md.properties.NonZero_seg = foo;
+                cout << "pixdeiff = " << md.properties.NonZero_seg << endl;
             } else 
                 cout << "ERROR: falscher Parameter für pixdiff [0..5000]\n";
         } else
             cout << "wrong parameter for optin --pixdiff\n";
+    // ---------------------- grid --------------------------------
+    } else if (strcmp (opt->name, "grid") == 0) {               // option --grid WxH
+        if (opt->has_arg == required_argument) {
+            int gx, gy;
+            if ((sscanf (optarg, "%dx%d", &gx, &gy) == 2) && 
+                (gx >= 1) && (gx <= MAX_TEILER) && (gy >= 1) && (gy <= MAX_TEILER)) {
+                md.properties.grid_x = gx;
+                md.properties.grid_y = gy;
+                cout << "grid = " << gx << "x" << gy << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für grid [1.." << MAX_TEILER << "]x[1.." << MAX_TEILER << "]\n";
+        } else
+            cout << "wrong parameter for optin --grid\n";
+    // ---------------------- lutcache --------------------------------
+    } else if (strcmp (opt->name, "lutcache") == 0) {           // option --lutcache
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--lutcache ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 1000)) {          // Plausibilität prüfen
+                md.properties.lut_cache = foo;
+                cout << "lutcache = " << md.properties.lut_cache << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für lutcache [0..1000]\n";
+        } else
+            cout << "wrong parameter for optin --lutcache\n";
+    // ---------------------- fastpre --------------------------------
+    } else if (strcmp (opt->name, "fastpre") == 0) {            // option --fastpre
+        md.properties.fast_pre = true;
+        cout << "fastpre = on\n";
+    // ---------------------- morph --------------------------------
+    } else if (strcmp (opt->name, "morph") == 0) {              // option --morph
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "vhgw") == 0)
+                md.properties.morph = MORPH_VHGW;
+            else if (strcmp (optarg, "cv") == 0)
+                md.properties.morph = MORPH_OPENCV;
+            else
+                cout << "ERROR: falscher Parameter für morph [vhgw | cv]\n";
+        } else
+            cout << "wrong parameter for optin --morph\n";
+    // ---------------------- pixfmt --------------------------------
+    } else if (strcmp (opt->name, "pixfmt") == 0) {             // option --pixfmt
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "bgr") == 0)
+                pixfmt = PIXFMT_BGR;
+            else if (strcmp (optarg, "yuyv") == 0)
+                pixfmt = PIXFMT_YUYV;
+            else if (strcmp (optarg, "mjpg") == 0)
+                pixfmt = PIXFMT_MJPG;
+            else
+                cout << "ERROR: falscher Parameter für pixfmt [bgr | yuyv | mjpg]\n";
+        } else
+            cout << "wrong parameter for optin --pixfmt\n";
+    // ---------------------- capture --------------------------------
+    } else if (strcmp (opt->name, "capture") == 0) {            // option --capture
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "cv") == 0)
+                capture = CAPTURE_CV;
+            else if (strcmp (optarg, "v4l2") == 0)
+                capture = CAPTURE_V4L2;
+            else
+                cout << "ERROR: falscher Parameter für capture [cv | v4l2]\n";
+        } else
+            cout << "wrong parameter for optin --capture\n";
+    // ---------------------- v4l2bufs --------------------------------
+    } else if (strcmp (opt->name, "v4l2bufs") == 0) {           // option --v4l2bufs
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--v4l2bufs ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= GRAB_RING_SIZE + 2) && (foo <= 32)) {   // Plausibilität prüfen
+                v4l2_bufs = foo;
+                cout << "v4l2bufs = " << v4l2_bufs << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für v4l2bufs [" << GRAB_RING_SIZE + 2 << "..32]\n";
+        } else
+            cout << "wrong parameter for optin --v4l2bufs\n";
+    // ---------------------- fps --------------------------------
+    } else if (strcmp (opt->name, "fps") == 0) {                // option --fps
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--fps ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 1) && (foo <= 60)) {          // Plausibilität prüfen
+                md.properties.fps = foo;
+                cout << "fps = " << md.properties.fps << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für fps [1..60]\n";
+        } else
+            cout << "wrong parameter for optin --fps\n";
+    // ---------------------- idlefps --------------------------------
+    } else if (strcmp (opt->name, "idlefps") == 0) {            // option --idlefps
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--idlefps ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 60)) {          // Plausibilität prüfen
+                md.properties.idle_fps = foo;
+                cout << "idlefps = " << md.properties.idle_fps << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für idlefps [0..60]\n";
+        } else
+            cout << "wrong parameter for optin --idlefps\n";
+    // ---------------------- threads --------------------------------
+    } else if (strcmp (opt->name, "threads") == 0) {            // option --threads
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--threads ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 16)) {          // Plausibilität prüfen
+                md.properties.threads = foo;
+                cout << "threads = " << md.properties.threads << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für threads [0..16]\n";
+        } else
+            cout << "wrong parameter for optin --threads\n";
+    // ---------------------- bgmodel --------------------------------
+    } else if (strcmp (opt->name, "bgmodel") == 0) {            // option --bgmodel
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "gauss") == 0)
+                md.properties.bg_mode = BG_GAUSS;
+            else if (strcmp (optarg, "mean") == 0)
+                md.properties.bg_mode = BG_MEAN;
+            else
+                cout << "ERROR: falscher Parameter für bgmodel [gauss | mean]\n";
+        } else
+            cout << "wrong parameter for optin --bgmodel\n";
+    // ---------------------- skip --------------------------------
+    } else if (strcmp (opt->name, "skip") == 0) {               // option --skip
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--skip ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 100)) {         // Plausibilität prüfen
+                md.properties.skip_max = foo;
+                cout << "skip = " << md.properties.skip_max << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für skip [0..100]\n";
+        } else
+            cout << "wrong parameter for optin --skip\n";
     // ---------------------- min videotime --------------------------------
     } else if (strcmp (opt->name, "minvidtime") == 0) {           // option --minvideotime
         if (opt->has_arg == required_argument) {
@@ -449,12 +593,12 @@ static void check_long_options (struct option *opt, char *optarg)
                 return;
             }
             if ((foo >= 2000)) {          
-                properties.min_time = foo;
-                cout << "minvidtime = " << properties.min_time << endl;
+                md.properties.min_time = foo;
+                cout << "minvidtime = " << md.properties.min_time << endl;
             } else {
                 cout << "ERROR: falscher Parameter für minvidtime [>=2000 ms]\n";
                 cout << "minvidtime wird auf 2000 ms gesetzt\n";
-                properties.min_time = 2000;
+                md.properties.min_time = 2000;
             }
         } else
             cout << "wrong parameter for optin --mnvidtime\n";
@@ -468,8 +612,8 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--maxvidtime ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            properties.max_time = foo;
-            cout << "maxvidtime = " << properties.max_time << endl;
+            md.properties.max_time = foo;
+            cout << "maxvidtime = " << md.properties.max_time << endl;
         } else
             cout << "wrong parameter for optin --maxidtime\n";
     // ------------------------- max video --------------------------------------
@@ -482,16 +626,200 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--maxvideo ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            sv.set_maxvideo (foo);
+            md.sv.set_maxvideo (foo);
         } else
             cout << "wrong parameter for optin --maxvid\n";
     // ---------------------
     } else if (strcmp (opt->name, "vidpath") == 0) {           // option --vidpath
         if (opt->has_arg == required_argument) {
             cout << "Path: " << optarg << endl;
-            properties.vidpath = optarg;
+            md.properties.vidpath = optarg;
         } else
             cout << "wrong parameter for optin --vidpath\n";
+    // ---------------------- vidqueue --------------------------------
+    } else if (strcmp (opt->name, "vidqueue") == 0) {           // option --vidqueue
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--vidqueue ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 256)) {
+                md.properties.vid_queue = foo;
+                cout << "vidqueue = " << md.properties.vid_queue << endl;
+            } else
+                cout << "ERROR: falscher Parameter für vidqueue [0..256]\n";
+        } else
+            cout << "wrong parameter for optin --vidqueue\n";
+    // ---------------------- vidpolicy --------------------------------
+    } else if (strcmp (opt->name, "vidpolicy") == 0) {          // option --vidpolicy
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "drop") == 0)
+                md.properties.vid_policy = SV_DROP;
+            else if (strcmp (optarg, "block") == 0)
+                md.properties.vid_policy = SV_BLOCK;
+            else
+                cout << "ERROR: falscher Parameter für vidpolicy [drop | block]\n";
+        } else
+            cout << "wrong parameter for optin --vidpolicy\n";
+    // ---------------------- codec --------------------------------
+    } else if (strcmp (opt->name, "codec") == 0) {              // option --codec
+        if (opt->has_arg == required_argument) {
+            int b;
+            for (b=SV_ENC_AUTO; b<=SV_ENC_MJPG; b++)
+                if (strcmp (optarg, sv_encoder::name (b)) == 0)
+                    break;
+            if (b <= SV_ENC_MJPG)
+                codec.backend = b;
+            else
+                cout << "ERROR: falscher Parameter für codec [auto | v4l2m2m | x264 | ffmpeg | mjpg]\n";
+        } else
+            cout << "wrong parameter for optin --codec\n";
+    // ---------------------- container --------------------------------
+    } else if (strcmp (opt->name, "container") == 0) {          // option --container
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "auto") == 0)
+                codec.container = SV_CONT_AUTO;
+            else if (strcmp (optarg, "mkv") == 0)
+                codec.container = SV_CONT_MKV;
+            else if (strcmp (optarg, "mp4") == 0)
+                codec.container = SV_CONT_MP4;
+            else if (strcmp (optarg, "avi") == 0)
+                codec.container = SV_CONT_AVI;
+            else
+                cout << "ERROR: falscher Parameter für container [auto | mkv | mp4 | avi]\n";
+        } else
+            cout << "wrong parameter for optin --container\n";
+    // ---------------------- bitrate --------------------------------
+    } else if (strcmp (opt->name, "bitrate") == 0) {            // option --bitrate
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--bitrate ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 100) && (foo <= 20000)) {     // Plausibilität prüfen
+                codec.bitrate = foo;
+                cout << "bitrate = " << codec.bitrate << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für bitrate [100..20000]\n";
+        } else
+            cout << "wrong parameter for optin --bitrate\n";
+    // ---------------------- gop --------------------------------
+    } else if (strcmp (opt->name, "gop") == 0) {                // option --gop
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--gop ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 1) && (foo <= 300)) {         // Plausibilität prüfen
+                codec.gop = foo;
+                cout << "gop = " << codec.gop << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für gop [1..300]\n";
+        } else
+            cout << "wrong parameter for optin --gop\n";
+    // ---------------------- quota --------------------------------
+    } else if (strcmp (opt->name, "quota") == 0) {              // option --quota
+        if (opt->has_arg == required_argument) {
+            long long foo;
+            try {
+                foo = std::stoll (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--quota ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 10000000)) {         // Plausibilität prüfen
+                quota_mb = foo;
+                cout << "quota = " << quota_mb << " MB" << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für quota [0..10000000]\n";
+        } else
+            cout << "wrong parameter for optin --quota\n";
+    // ---------------------- minfree --------------------------------
+    } else if (strcmp (opt->name, "minfree") == 0) {            // option --minfree
+        if (opt->has_arg == required_argument) {
+            long long foo;
+            try {
+                foo = std::stoll (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--minfree ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 10000000)) {         // Plausibilität prüfen
+                minfree_mb = foo;
+                cout << "minfree = " << minfree_mb << " MB" << endl;
+            } else 
+                cout << "ERROR: falscher Parameter für minfree [0..10000000]\n";
+        } else
+            cout << "wrong parameter for optin --minfree\n";
+    // ---------------------- record --------------------------------
+    } else if (strcmp (opt->name, "record") == 0) {             // option --record
+        if (opt->has_arg == required_argument) {
+            if (strcmp (optarg, "composite") == 0)
+                md.properties.record = RECORD_COMPOSITE;
+            else if (strcmp (optarg, "raw") == 0)
+                md.properties.record = RECORD_RAW;
+            else
+                cout << "ERROR: falscher Parameter für record [composite | raw]\n";
+        } else
+            cout << "wrong parameter for optin --record\n";
+    // ---------------------- preroll --------------------------------
+    } else if (strcmp (opt->name, "preroll") == 0) {            // option --preroll
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--preroll ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 30000)) {
+                md.properties.preroll = foo;
+                cout << "preroll = " << md.properties.preroll << " ms\n";
+            } else
+                cout << "ERROR: falscher Parameter für preroll [0..30000 ms]\n";
+        } else
+            cout << "wrong parameter for optin --preroll\n";
+    // ---------------------- prerollmem --------------------------------
+    } else if (strcmp (opt->name, "prerollmem") == 0) {         // option --prerollmem
+        if (opt->has_arg == required_argument) {
+            int foo;
+            try {
+                foo = std::stoi (optarg);
+            } catch (std::invalid_argument const& ex) {
+                std::cout << "--prerollmem ERROR " << "#1: " << ex.what() << '\n';
+                return;
+            }
+            if ((foo >= 0) && (foo <= 1048576)) {
+                md.properties.preroll_mem = foo;
+                cout << "prerollmem = " << md.properties.preroll_mem << " kB\n";
+            } else
+                cout << "ERROR: falscher Parameter für prerollmem [0..1048576 kB]\n";
+        } else
+            cout << "wrong parameter for optin --prerollmem\n";
+    // ---------------------- input --------------------------------
+    } else if (strcmp (opt->name, "input") == 0) {              // option --input
+        if (opt->has_arg == required_argument) {
+            input_path = optarg;
+            md.properties.replay = true;
+            cout << "input = " << input_path << endl;
+        } else
+            cout << "wrong parameter for optin --input\n";
+    // ---------------------- csv --------------------------------
+    } else if (strcmp (opt->name, "csv") == 0) {                // option --csv
+        if (opt->has_arg == required_argument) {
+            csv_path = optarg;
+            cout << "csv = " << csv_path << endl;
+        } else
+            cout << "wrong parameter for optin --csv\n";
     // ---------------------- ignorleft --------------------------------
     } else if (strcmp (opt->name, "ignorleft") == 0) {           // option --ignorleft
         if (opt->has_arg == required_argument) {
@@ -502,8 +830,8 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--ignorleft ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            ignor_geo.ignorleft = foo;
-            cout << "ignorleft = " << ignor_geo.ignorleft << endl;
+            md.ignor_geo.ignorleft = foo;
+            cout << "ignorleft = " << md.ignor_geo.ignorleft << endl;
         } else
             cout << "wrong parameter for optin --ignorleft\n";
     // ---------------------- ignortop --------------------------------
@@ -516,8 +844,8 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--ignortop ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            ignor_geo.ignortop = foo;
-            cout << "ignortop = " << ignor_geo.ignortop << endl;
+            md.ignor_geo.ignortop = foo;
+            cout << "ignortop = " << md.ignor_geo.ignortop << endl;
         } else
             cout << "wrong parameter for optin --ignortop\n";
     // ---------------------- ignorwidth --------------------------------
@@ -530,8 +858,8 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--ignorwidth ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            ignor_geo.ignorwidth = foo;
-            cout << "ignorwidth = " << ignor_geo.ignorwidth << endl;
+            md.ignor_geo.ignorwidth = foo;
+            cout << "ignorwidth = " << md.ignor_geo.ignorwidth << endl;
         } else
             cout << "wrong parameter for optin --ignorwidth\n";
     // ---------------------- ignorheight --------------------------------
@@ -544,8 +872,8 @@ static void check_long_options (struct option *opt, char *optarg)
                 std::cout << "--ignorheight ERROR " << "#1: " << ex.what() << '\n';
                 return;
             }
-            ignor_geo.ignorheight = foo;
-            cout << "ignorheight = " << ignor_geo.ignorheight << endl;
+            md.ignor_geo.ignorheight = foo;
+            cout << "ignorheight = " << md.ignor_geo.ignorheight << endl;
         } else
             cout << "wrong parameter for optin --ignorheight\n";
     // ---------------------            
@@ -566,14 +894,23 @@ static void check_long_options (struct option *opt, char *optarg)
  */
 int check_plausibiliti_of_opt ()
 {
-    if (properties.max_time < properties.min_time) {
+    if (md.properties.max_time < md.properties.min_time) {
         cout << "WARNING: maxvideotime < minvideotime\n";
-        properties.max_time = properties.min_time;
+        md.properties.max_time = md.properties.min_time;
 
         return EXIT_FAILURE;
     }
 
-    // properties.NonZero_seg
+    if ((cams.size() > 1) && md.properties.replay) {
+        cout << "WARNING: --input arbeitet nur mit einer Kamera. Es gilt --cam " << cams[0] << endl;
+        cams.resize (1);
+    }
+    if ((cams.size() > 1) && !csv_path.empty()) {
+        cout << "WARNING: --csv arbeitet nur mit einer Kamera\n";
+        csv_path.clear ();
+    }
+
+    // md.properties.NonZero_seg
 
     return EXIT_SUCCESS;
 }
@@ -598,16 +935,41 @@ int control_opt (int argc, char ** argv)
         { "cam", required_argument, 0, 'c' },           // Camera Index
         { "manuell", no_argument, 0, 'm' },             // manueller Start
         { "noutput", no_argument, 0, 'n' },             // kein Bildschirmausgabe
-        { "diff", required_argument, 0, 'd' },          // Pixeldifferenz zum Vorgängerbild <properties.video_start_diff>
+        { "diff", required_argument, 0, 'd' },          // Pixeldifferenz zum Vorgängerbild <md.properties.video_start_diff>
         { "gray", no_argument, 0, 'g' },
         { "trail", required_argument, 0, 'a' },         // Nachlauf in frames
         { "picture", no_argument, 0, 'p' },             // Bildmodus
         { "pixdiff", required_argument, 0, 0 },         // Pixel-Differenz[0..5000] für Mosaik-Segment
+        { "grid", required_argument, 0, 0 },            // Mosaik-Auflösung WxH
+        { "lutcache", required_argument, 0, 0 },        // Stretch-LUT nur alle n Bilder
+        { "fastpre", no_argument, 0, 0 },               // schnelle Vorverarbeitung
+        { "morph", required_argument, 0, 0 },           // vhgw | cv
+        { "pixfmt", required_argument, 0, 0 },          // bgr | yuyv | mjpg
+        { "capture", required_argument, 0, 0 },         // cv | v4l2
+        { "v4l2bufs", required_argument, 0, 0 },        // Anzahl Treiberpuffer bei --capture v4l2
+        { "fps", required_argument, 0, 0 },             // Ziel-Framerate der Auswertung
+        { "idlefps", required_argument, 0, 0 },         // Framerate bei ruhigem Bild
+        { "threads", required_argument, 0, 0 },         // Mosaik-Felder parallel zählen
+        { "bgmodel", required_argument, 0, 0 },         // gauss | mean
+        { "skip", required_argument, 0, 0 },            // Vorfilter: max. übersprungene Bilder in Folge
         { "maxframe", required_argument, 0, 0 },        // Max.Anzahl Bilder pro Video. Default 100
         { "maxvideo", required_argument, 0, 0 },        // Max.Anzahl Video's, default -1, d.h keine Begrenzung
         { "minvidtime", required_argument, 0, 0 },
         { "maxvidtime", required_argument, 0, 0 },
         { "vidpath", required_argument, 0, 0 },
+        { "vidqueue", required_argument, 0, 0 },        // Tiefe der Video-Warteschlange
+        { "vidpolicy", required_argument, 0, 0 },       // drop | block
+        { "codec", required_argument, 0, 0 },           // auto | v4l2m2m | x264 | ffmpeg | mjpg
+        { "container", required_argument, 0, 0 },       // auto | mkv | mp4 | avi
+        { "bitrate", required_argument, 0, 0 },         // H.264-Bitrate in [kbit/s]
+        { "gop", required_argument, 0, 0 },             // Abstand der Keyframes
+        { "quota", required_argument, 0, 0 },           // Max. Platz aller Dateien in [MB]
+        { "minfree", required_argument, 0, 0 },         // Min. freier Platz in [MB]
+        { "record", required_argument, 0, 0 },          // composite | raw
+        { "preroll", required_argument, 0, 0 },         // Pre-Roll in [ms]
+        { "prerollmem", required_argument, 0, 0 },      // Max. Speicher für den Pre-Roll in [kB]
+        { "input", required_argument, 0, 0 },           // Replay: Video-Datei oder Verzeichnis
+        { "csv", required_argument, 0, 0 },             // Protokoll je Bild
         { "camwidth", required_argument, 0, 'w' },      // Karabild Breite
         { "camheight", required_argument, 0, 'i' },     // Kamerabild Höhe
 
@@ -690,43 +1052,47 @@ int control_opt (int argc, char ** argv)
                 }   
                 break;
             case 'p':       // -p --picture   save only picture
-                properties.only_picture = true;
+                md.properties.only_picture = true;
                 cout << "only picture\n";
                 break;
-            case 'd': {     // -d --diff <arg>      Pixel-Differenz zum Vorgängerbild [1..5000]; default: " << properties.video_start_diff << endl;
+            case 'd': {     // -d --diff <arg>      Pixel-Differenz zum Vorgängerbild [1..5000]; default: " << md.properties.video_start_diff << endl;
                     int foo = std::stoi (optarg);
                     if ((foo > 0) && (foo <= 5000))
-                        properties.video_start_diff = foo;
+                        md.properties.video_start_diff = foo;
                     else 
                         cout << "ERROR: falscher Parameter für --diff [1..5000]\n";
                 }
                 break;
-            case 'a': {     // -a --trail <arg>     Nachlauf in frames; default: " << properties.trail << endl;
+            case 'a': {     // -a --trail <arg>     Nachlauf in frames; default: " << md.properties.trail << endl;
                     int foo = std::stoi (optarg);
-                    properties.trail = foo;
-                    cout << "Nachlauf: " << properties.trail << " frames\n";
+                    md.properties.trail = foo;
+                    cout << "Nachlauf: " << md.properties.trail << " frames\n";
                 }
                 break;
             case 'g':       // gray
-                sv.set_gray (true);
+                md.sv.set_gray (true);
                 break;
             case 'e': {     // -e --threshold <arg> Schwellwert     
                     uint8_t foo = std::stof (optarg);
-                    properties.threshold = foo;
-                    cout << "sense= " << properties.threshold << endl;
+                    md.properties.threshold = foo;
+                    cout << "sense= " << md.properties.threshold << endl;
                 }
                 break;
             case 'c': {     // Camera-Nr
                     int foo = std::stoi (optarg);
-                    properties.cam_index = foo;
+                    if (cams.size() >= MAX_CAMS)
+                        cout << "ERROR: max. " << MAX_CAMS << " Kameras. --cam " << foo << " wird ignoriert\n";
+                    else if (std::find (cams.begin(), cams.end(), foo) == cams.end())
+                        cams.push_back (foo);       // --cam mehrfach: eine Pipeline je Kamera
+                    md.properties.cam_index = cams[0];
                 }
                 break;
             case 'm':       // start prog manuell
                 cout << "Start prozess with key m\n";
-                properties.run = false;
+                md.properties.run = false;
                 break;
             case 'n':       // keine Ausgabe
-                properties.no_output = true;
+                md.properties.no_output = true;
                 break;
             case 0: /* all parameter that do not */
                     /* appear in the optstring */
@@ -826,43 +1192,6 @@ int getch()
     return ch;
 }
 
-/*! --------------------------------------------------------------
- * @brief Prüft ob Datei vorhanden ist.
- * @return 1: Datei vorhanden\n
- *         0: keine Datei gefunden
- */
-inline bool file_exists (const std::string& fname) 
-{
-    ifstream f(fname.c_str());  // input file streams
-    return f.good();
-}
-
-/*! --------------------------------------------------------------------
- * @brief   Funktion sucht die höchste Tages-Video-Nr, z.B out12.avi\n
- *          Es wird dann die nächste Nr als aktueller vid_counter definiert.
- */
-void init_vid_counter()
-{
-    int n=0;
-    bool treffer = false;
-    char buf[512];
-
-    while ((n<1000) && !treffer) {
-        if (!properties.only_picture)
-            sprintf (buf, "%s/out%i.avi", folder.c_str(), n);   // video-mode
-        else 
-            sprintf (buf, "%s/out%i.jpg", folder.c_str(), n);   // picture-mode
-
-        if (file_exists(buf)) 
-            ++n;
-        else 
-            treffer = true;
-    }
-
-    if (treffer)
-       vid_counter = n; 
-}
-
 /*! ----------------------------------------------------------
  * @brief Get the homedir object\n
  *        Pfad wird in {@ref home_dir} abgelegt!
@@ -935,7 +1264,7 @@ int make_path (std::string pname)
 }
 
 /*! -------------------------------------------------------------
- * @brief Initialisiert das Verzeichnis @ref folder
+ * @brief Initialisiert das Verzeichnis @ref MotionDetector::folder
  * @return EXIT_SUCCESS, wenn das Verzeichnis erfolgreich initialisiert wurde, andernfalls EXIT_FAILURE.
  */
 int init_folder()
@@ -949,516 +1278,232 @@ int init_folder()
     char buf[256];
     sprintf (buf, "/%i_%i_%i", now.tm_mday, now.tm_mon+1, now.tm_year+1900);
 
-    if (!properties.vidpath.empty()) {
-        parent_folder = properties.vidpath;
-        parent_folder += buf;
+    if (!md.properties.vidpath.empty()) {
+        video_root = md.properties.vidpath;
+        parent_folder = video_root + buf;
         path_is_ok = make_path (parent_folder);
     } 
 
     if (path_is_ok == EXIT_FAILURE) {
-        parent_folder = home_dir;
-        parent_folder += "/lookat_video";
-        parent_folder += buf;
+        video_root = home_dir;
+        video_root += "/lookat_video";
+        parent_folder = video_root + buf;
         if (make_path (parent_folder) == EXIT_FAILURE)
             return EXIT_FAILURE;
     }
 
-    folder = parent_folder;
+    md.folder = parent_folder;
 
     return EXIT_SUCCESS;
 }
 
-/*! -----------------------------------------------------------
- * @brief 
+/*! ------------------------------------------------------------
+ * @brief Kamera öffnen: mit cv::VideoCapture oder bei --capture v4l2 mit @ref v4l2_capture.\n
+ *        Das Format wird vor der Bildgrösse eingestellt (@ref get_cam_para()).
+ * @param g Grabber der Kamera
+ * @param cam_index Kamera-Nr
+ * @param fmt --pixfmt. Wird auf das tatsächlich eingestellte Format gesetzt.
+ * @return false: Kamera kann nicht geöffnet werden.
  */
-cv::Mat make_ausgabe_screen (cv::Mat src, cv::Mat seg_screen)
+static bool open_camera (frame_grabber &g, int cam_index, int &fmt)
 {
-    cv::Mat src_2;
-    if (seg_screen.type() == CV_8UC1)
-        cv::cvtColor (seg_screen, src_2, cv::COLOR_GRAY2BGR);       // Farbbild erzeugen => src2
-    else 
-        seg_screen.copyTo(src_2);                                   // seg_screen copy to => src2
-
-
-    cv::Mat foo = cv::Mat (src.rows, src.cols + src_2.cols+10, CV_8UC3);    // Gesamtbild = src + seg_screen
-    foo = cv::Scalar(255, 255, 255);                                        // Gesamtbild = white
-    cv::Mat roi(foo, cv::Rect(0, 0, src.cols, src.rows));                   // ROI for src
-
-    // Sensitiven Bildausschnitt zeichnen
-    if ((geo.left != 0) || (geo.top != 0) || (geo.right != src.cols-1) || (geo.bottom != src.rows-1))
-        cv::rectangle (src, 
-                    cv::Point (geo.left, geo.top), cv::Point (geo.right, geo.bottom),
-                    cv::Scalar(0, 0, 255), 
-                    1);
-                
-    src.copyTo (roi);   // src ind Videobild eintragen
-    cv::Mat roi2(foo, cv::Rect(src.cols+5, 0, src_2.cols, src_2.rows));     // ROI for seg_screen (src_2)
-    src_2.copyTo (roi2);    // seg_screen in Videobild eintragen
-
-    return foo;
+    if (capture == CAPTURE_V4L2) {
+        if (!g.open_v4l2 (cam_index, camwidth, camheight, fmt, v4l2_bufs)) {
+            cout << "NO CAMERA " << cam_index << " (--capture v4l2)\n";
+            return false;
+        }
+        if (fmt != g.get_pixfmt())
+            cout << "--capture v4l2: die Kamera liefert YUYV. BGR nur für Anzeige und Video\n";
+        fmt = g.get_pixfmt();
+    } else if (!g.open (cam_index, cv::CAP_V4L2)) {     // check if we succeeded
+        cout << "NO CAMERA " << cam_index << endl;
+        return false;
+    } else if ((fmt != PIXFMT_BGR) && !g.set_pixfmt (fmt)) {     // vor get_cam_para(): Format vor der Bildgrösse
+        cout << "ERROR --pixfmt wird von der Kamera nicht unterstützt. Es bleibt bei bgr\n";
+        fmt = PIXFMT_BGR;
+    }
+    return true;
 }
 
-/*! -------------------------------------------------------
- * 
+/*! ------------------------------------------------------------
+ * @brief VideoCaptureProperties werden gelesen\n
+ *        Vor dem lesen werden noch Bildbreite und Bildhöhe eingestellt.\n
+ *        Muss vor <grabber.start()> aufgerufen werden.\n 
+ * @see {@ref show_cam_para()}
  */
-void write_diff_non_zero_to_diff ()
+static void get_cam_para (frame_grabber &g)
 {
-    char buf[256];
+    g.set(cv::CAP_PROP_FRAME_WIDTH, camwidth);
+    g.set(cv::CAP_PROP_FRAME_HEIGHT, camheight);
 
-    sprintf (buf, "%i", properties.diff_non_zero);
-    cv::putText(diff,                    // target image
-                buf,                            // text
-                cv::Point(10, 20),              // top-left position
-                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
-                1.0,                            // fontScale
-                255,                            // font color
-                2);                             // thickness
+    // ------------------ Camera Parameter ----------------------------
+    cam_para.saturation = g.get (cv::CAP_PROP_SATURATION);      // 1
+    cam_para.brightness = g.get (cv::CAP_PROP_BRIGHTNESS);      // 0
+    cam_para.contrast = g.get (cv::CAP_PROP_CONTRAST);          // 1
+    cam_para.exposure = g.get (cv::CAP_PROP_EXPOSURE);          // 157
+    cam_para.fwidth = g.get (cv::CAP_PROP_FRAME_WIDTH);
+    cam_para.fheight = g.get (cv::CAP_PROP_FRAME_HEIGHT);
 }
 
-/*! -------------------------------------------------
- * @brief   Funktion erzeugt aus <src> ein Mosaik
+/*! ------------------------------------------------------------
+ * @brief Ausgabe der VideoCaptureProperties
+ * @see {@ref get_cam_para()}
  */
-void make_seg (cv::Mat basis)
+static void show_cam_para ()
 {
-    int w = basis.cols / HORZ_TEILER;
-    int h = basis.rows / VERT_TEILER;
-
-    /* code berechnet den Rest der Fensterteilung. Wird z.Z. noch nicht benötigt. 
-    int wr = src.cols % HORZ_TEILER;
-    int hr = src.rows % VERT_TEILER;
-    */
-
-    // ------------ Mosaik einrichten -------------------   
-    for (int y=0; y<VERT_TEILER; y++) {
-        for (int x=0; x<HORZ_TEILER; x++) {
-            seg[first_in][x][y] = basis(cv::Rect(x*w, y*h, w, h));    // ROI einrichten
-        }
-    }
-
-    // ------------- Differenz NonZero für jedes Mosaik-Bild ermitteln -----------
-    seg_NonZero = 0;    // cv::Mat auf 0 setzen !!!
-    for (int y=0; y<VERT_TEILER; y++) {
-        for (int x=0; x<HORZ_TEILER; x++) {
-            if (!seg[first_in][x][y].empty() && !seg[last_in][x][y].empty()) {
-                cv::absdiff (seg[first_in][x][y], seg[last_in][x][y], seg_diff[x][y]);  // Bilder subtrahieren
-                cv::threshold (seg_diff[x][y], seg_diff[x][y], properties.threshold, 255, THRESH_TOZERO);  // Pixel < properties.threshold = 0
-                // -------- Nachschauen, ob Anzahl Farb-Pixel grösser ist als properties.NonZero_seg ---------
-                if (cv::countNonZero(seg_diff[x][y]) > properties.NonZero_seg)  // --pixdiff für Mosaik, default 25
-                    seg_NonZero.at<uchar>(y, x) = 128;
-            }
-        }
-    }
-
-    #define RESIZE_FAKTOR 40.0f
-    // ------------------------- Contours ---------------------------------------------
-    cv::resize (seg_NonZero, contours_pic, cv::Size(0, 0), RESIZE_FAKTOR, RESIZE_FAKTOR);
-
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours (contours_pic, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE );
-    std::vector<cv::Point> center;
-    for (size_t i=0; i<contours.size(); i++) {
-        cv::Moments m = cv::moments(contours[i]);
-        center.push_back (cv::Point(m.m10 / m.m00, m.m01 / m.m00));
-    }
-
-    int cx = 0;
-    for (size_t i=0; i<center.size(); i++) {
-        cv::circle (contours_pic, center[i], 5, 255, 1);    
-        cx += center[i].x;
-    }
-    if (cx != 0) 
-        contour_x_center = cx / center.size();
-
-    cv::line (contours_pic, cv::Point(contour_x_center, 0), cv::Point (contour_x_center, contours_pic.rows-1), 255, 1);
-
-    char buf[256];
-    sprintf (buf, "%ld  %2.1f%c", static_cast<long int>(contours.size()), (float)contour_x_center / (float)contours_pic.cols * 100.f, '%');
-    cv::putText(contours_pic,                   // target image
-                buf,                            // text
-                cv::Point(10, 20),              // top-left position
-                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
-                1.0,                            // fontScale
-                255,                            // font color
-                2);                             // thickness
-
-#ifdef SHOW_MOSAIK
-    // --------------- Mosaik - Bild erzeugen ---------------------
-    show_seg = cv::Mat(h*VERT_TEILER + 5*VERT_TEILER+5,     // rows
-                       w*HORZ_TEILER + 5*HORZ_TEILER+5,     // cols
-                       CV_8UC3 );
-    show_seg = cv::Scalar (255, 255, 255);
-    for (int y=0; y<VERT_TEILER; y++) {
-        for (int x=0; x<HORZ_TEILER; x++) {
-            if (!seg_diff[x][y].empty()) {
-                cv::Mat foo(show_seg, cv::Rect(x*w+5*x+5, y*h+5*y+5, w, h));
-                cv::Mat dummy;
-                seg[first_in][x][y].copyTo ( dummy );
-                cv::cvtColor (dummy, dummy, cv::COLOR_GRAY2BGR);
-                dummy.copyTo ( foo );
-                if (seg_NonZero.at<uchar>(y, x))
-                    cv::rectangle (show_seg, cv::Rect(x*w+5*x+5, y*h+5*y+5, w, h), cv::Scalar(0, 0, 255), 3);
-            }
-        }
-    }
-#endif
+    cout << "--------- cam para ----------\n";
+    cout << "cam_para.saturation: " << cam_para.saturation << endl;
+    cout << "cam_para.brightness: " << cam_para.brightness << endl;
+    cout << "cam_para.contrast: " << cam_para.contrast << endl;
+    cout << "cam_para.exposure: " << cam_para.exposure << endl;
+    cout << "cam_para.fwidth: " << cam_para.fwidth << endl;
+    cout << "cam_para.fheight: " << cam_para.fheight << endl;
 }
 
-/*! ----------------------------------------------------------------------------------
- * @brief Funktion vergleicht die Option `properties.NonZero_seg` mit der Mosaikfläche (seg_diff.cols * seg_diff.rows).
- *
- * Diese Funktion überprüft, ob der Wert von `properties.NonZero_seg` größer oder gleich
- * der Anzahl der Pixel in der Mosaikfläche ist. Wenn dies der Fall ist, wird eine Warnung
- * ausgegeben und der Wert von `properties.NonZero_seg` auf die Mosaikfläche minus 1
- * zurückgesetzt. Anschließend gibt die Funktion den Wert von `properties.NonZero_seg` zurück.
- *
- * @return Der Wert von `properties.NonZero_seg` nach der Überprüfung.
+/*! ------------------------------------------------------------
+ * @brief Auftrag im @ref worker_pool: ein Schritt der Pipeline einer Kamera.\n
+ *        Danach stellt sich der Auftrag zum Termin aus @ref MotionDetector::get_due() selbst wieder ein.
+ *        Je Kamera ist also höchstens ein Auftrag unterwegs; die state-machine läuft nie parallel.
  */
-int check_pixdiff ()
+static void camera_job (struct _camera_ *c)
 {
-    int anz_pix = seg_diff[0][0].cols * seg_diff[0][0].rows;
-
-    if (properties.NonZero_seg >= anz_pix) {
-        cout << "WARNING: --pixdiff ist > als Mosaik-Fläche\n";
-        cout << "Mosaik-Fläche: " << seg_diff[0][0].cols << " / " << seg_diff[0][0].rows << " = " << anz_pix << endl;
-        cout << "--pixdiff: " << properties.NonZero_seg << endl; 
-        cout << "--pixdiff wird zurückgesetzt auf Mosaik-Fläche-1\n";
-    }
+    MotionDetector &m = c->md;
+
+    m.properties.run = c->run.load();
+    if (!c->ready) {                    // Bildeinzug initialisieren
+        m.get_frame ();
+        if (m.is_ready()) {
+            m.check_pixdiff ();
+            m.anz_sensetive_pixel = m.get_anzahl_sensetive_pixel();
+            c->ready = true;
+        }
+    } else if (m.control())             // Betriebszustände überwachen.
+        ++c->frames;
 
-    return properties.NonZero_seg;
+    c->videos = m.vid_counter;
+    c->idle = m.is_idle();
+    if (!cams_ende)
+        pool.submit (std::bind (camera_job, c), m.get_due());
 }
 
-/*! ----------------------------------------------------------
- * @brief Gibt die Anzahl der sensitiven Pixel zurück.
- *
- * Diese Funktion berechnet die Anzahl der sensitiven Pixel in einem Bild. \n
- * Die Berechnung ergibt sich aus (sensetive Fläche - ignor Fläche) \n
- * Die sensetive Fläche ist @ref geo gespeichert. Die ignor Fläche ist in @ref ignor_geo gesichert.
- * 
- * @return Die Anzahl der sensitiven Pixel.
+/*! ------------------------------------------------------------
+ * @brief Statistik je Kamera. Wird vom Haupt-Thread aufgerufen; gelesen werden nur atomare Werte.
  */
-int get_anzahl_sensetive_pixel()
+static void show_cam_stat ()
 {
-    cv::Mat foo (src_image.rows, src_image.cols, CV_8UC1, cv::Scalar(0));
-    cv::rectangle (foo, cv::Rect(geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1), 255, -1);
-    if (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0) {
-        cv::rectangle (foo, 
-                       cv::Rect (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight),
-                       cv::Scalar(0), 
-                       -1);
+    for (int i=0; i<anz_cameras; i++) {
+        struct _camera_ &c = cameras[i];
+        cout << "-------- cam " << c.cam_index << " ---------\n";
+        cout << "folder:     " << c.md.folder << endl;
+        cout << "frames:     " << c.frames << ((c.idle) ? " (idle)" : "") << ((c.run) ? "" : " (inaktiv)") << endl;
+        cout << "captured:   " << c.grabber.get_captured() << endl;
+        cout << "dropped:    " << c.grabber.get_dropped() << endl;
+        cout << "next video: " << c.videos << endl;
     }
-
-    return cv::countNonZero(foo);
 }
 
-/*! -------------------------------------------------
- * @brief   Bildeinzug und Bewegungserkennung.
- *
- * Die Bewegungserkennung arbeitet mit <absdiff()> \n
- * Sobald eine Bewegung erkannt wird, wechselt @ref <properties.falle_aktiv> auf true. \n
- * <properties.falle_aktiv> wird in @ref control() ausgewertet.
+/*! ------------------------------------------------------------
+ * @brief Mehrere Kameras (Option --cam mehrfach) in einem Prozess.\n
+ *        Je Kamera eine Pipeline (@ref _camera_) mit eigenem Unterverzeichnis cam<N>.
+ *        Alle Pipelines laufen auf einem gemeinsamen @ref worker_pool mit einem Thread je CPU-Kern.
+ *        Die Bildschirmausgabe ist abgeschaltet; die Tastatur wird im Terminal abgefragt.
+ * @return 0 oder -1, wenn keine Kamera geöffnet werden konnte.
  */
-void get_frame()
+static int run_cameras ()
 {
-    first_in = (first_in < MAX_IN-1) ? first_in+1 : 0;  // Ringzähler weiterschieben
-    last_in = (last_in < MAX_IN-1) ? last_in+1 : 0;
-    properties.falle_aktiv = false;
-    properties.frame_delay = MAX_DELAY;
-
-    cap >> src_image;                                   // Bildeinzug
-    cv::Mat dummy;
-    src_image.copyTo (dummy);
-    if (ignor_geo.ignorwidth != 0 && ignor_geo.ignorheight != 0) {
-        cv::rectangle (dummy, 
-                       cv::Rect2d (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight), 
-                       cv::Scalar (0, 0, 0),
-                       -1);
-        cv::rectangle (src_image, 
-                       cv::Rect2d (ignor_geo.ignorleft, ignor_geo.ignortop, ignor_geo.ignorwidth, ignor_geo.ignorheight), 
-                       cv::Scalar (0, 0, 255),
-                       2);
+    cv::setNumThreads (1);      // parallel wird über die Kameras gearbeitet, nicht innerhalb von OpenCV
+
+    for (size_t i=0; i<cams.size(); i++) {
+        struct _camera_ *c = &cameras[anz_cameras];
+        MotionDetector &m = c->md;
+        int fmt = pixfmt;
+
+        c->cam_index = cams[i];
+        if (!open_camera (c->grabber, cams[i], fmt))
+            continue;
+        get_cam_para (c->grabber);
+
+        m.properties = md.properties;
+        m.properties.cam_index = cams[i];
+        m.properties.no_output = true;
+        m.properties.threads = 1;               // cv::setNumThreads() gilt prozessweit; parallel über die Kameras
+        m.ignor_geo = md.ignor_geo;
+        m.folder = md.folder + "/cam" + std::to_string (cams[i]);     // Videos je Kamera getrennt
+        if (make_path (m.folder) == EXIT_FAILURE) {
+            cout << "ERROR cant create " << m.folder << endl;
+            continue;
+        }
+        m.sv.set_storage (md.sv.get_storage());     // ein Index für alle Kameras
+        m.init_vid_counter();
+        m.sv.set_gray (md.sv.get_gray_flag());
+        m.sv.set_maxvideo (md.sv.get_maxvideo());
+        m.sv.set_codec (md.sv.get_codec());
+        m.sv.set_sidecar (md.sv.get_sidecar());
+        if (!m.properties.only_picture)
+            m.sv.set_preroll (m.properties.preroll, m.properties.preroll_mem);
+        m.sv.set_async (m.properties.vid_queue, m.properties.vid_policy);
+        m.reset_geo (new_geo, cam_para.fwidth, cam_para.fheight);
+        m.set_source (&c->grabber);
+        m.set_pooled (true);
+        c->run = md.properties.run;
+        c->grabber.start ();
+
+        cout << "cam " << cams[i] << ": " << cam_para.fwidth << "x" << cam_para.fheight << " => " << m.folder << endl;
+        ++anz_cameras;
     }
+    if (anz_cameras == 0)
+        return -1;
 
-    src[first_in] = dummy(cv::Rect(geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1)); // ROI
-    now[first_in] = time(NULL);                         // Aufnahme-Zeitpunkt festhalten.
-
-    cv::Mat gray;
-    CVD::cvtColor (src[first_in], gray, cv::COLOR_BGR2GRAY);    // Graustufenbild
-
-    // ----------------- stretch gray image -------------------
-    Histogram1D h;
-
-#ifdef SHOW_HISTOGRAM
-    cv::Mat hist = h.getHistogram( gray );
-    if (!properties.no_output)
-        cv::imshow ("Hist", h.getImageOfHistogram(hist, 1.0f));     // Ausgabe original Histogram
-#endif
-    gray = h.stretch( gray, 0.0050f );                              // Histogram wird gestretcht.
-
-#ifdef SHOW_HISTOGRAM
-    hist = h.getHistogram( gray );
-    if (!properties.no_output)
-        cv::imshow ("Hist gestretcht", h.getImageOfHistogram(hist, 1.0f));   // Ausgabe gestretchtes Histogram
-#endif
-    // --------- End of stretch gray image --------------------
-
-#ifdef USE_HARRIS_DETECTOR
-    // ---------------------- Harris Corner -----------------------
-    gray.copyTo (harrisCorners);
-    harris.detect(gray);                                // Compute Harris corners
-    std::vector<cv::Point> pts;
-    harris.getCorners(pts, 0.02);                       // ermittle Koordinaten
-    harris.drawOnImage(harrisCorners, pts, 255, 10, 2);  // Draw Harris corners
-    cv::resize (harrisCorners, harrisCorners, cv::Size(), 0.5, 0.5);    // Bild verkleinern
-
-    char buf[256];
-    sprintf (buf, "%ld", static_cast<long int>(pts.size()));
-    cv::putText(harrisCorners,                  // target image
-                buf,                            // text
-                cv::Point(10, 20),              // top-left position
-                cv::FONT_HERSHEY_PLAIN,         // FONT_HERSHEY_PLAIN, FONT_HERSHEY_DUPLEX
-                1.0,                            // fontScale
-                255,                            // font color
-                2);                             // thickness
-#endif
-
-#ifdef USE_FEATURE_DETECTOR
-    gray.copyTo (harrisCorners);        // aktuelles Bild kopieren
-    // -------------------- detector -----------------------
-    pyrKeypoints.clear();
-    detector->detect(gray, pyrKeypoints);
+    pool.start ();              // ein Thread je CPU-Kern
+    cout << anz_cameras << " Kameras, " << pool.size() << " Worker-Threads\n";
+    for (int i=0; i<anz_cameras; i++)
+        pool.submit (std::bind (camera_job, &cameras[i]));
 
-    std::vector<cv::Point> points;
-    std::vector<cv::KeyPoint>::iterator it;
-    for( it= pyrKeypoints.begin(); it!= pyrKeypoints.end(); it++)
-        points.push_back(it->pt);
+    show_short_keys ();
 
-    harris.drawOnImage(harrisCorners, points, 255, 7, 1);  // Draw Harris corners
-    // std::cout << "Interest points: Mat gray=" << pyrKeypoints.size() << std::endl;
-#endif
+    int ende = 0;
+    while (!ende) {
+        usleep (50000);
+        if (!kbhit())
+            continue;
 
-    // ---------------------- smooth ------------------------
-    cv::boxFilter (gray, gray, -1, cv::Size(6, 6));            // glätten: blur, gaussianBlur, filter2D, medianBlur, bilateralFilter, ...
-
-    /* // ------------------- Versuch -----------------
-    cv::Mat dummy;
-    CVD::Laplacian (gray, dummy, CV_64F, 1, 1, 0);
-    CVD::Sobel (dummy, dummy, CV_64F, 1, 1, 5);
-    CVD::convertScaleAbs( dummy, gray );           // converting back to CV_8U
-    */
-
-    cv::dilate(gray, gray, Mat(), Point(-1, -1), 6, 1, 1);
-    cv::erode(gray, gray, Mat(), Point(-1, -1), 6, 1, 1);
-    cv::pyrDown (gray, gray, cv::Size(0, 0));
-    make_seg (gray);
-    cv::pyrDown (gray, gray, cv::Size(0, 0));      // gray enthält das runter gebrochene Bild !!!
-
-    gray.copyTo (in[first_in]);                     // dieser Schritt könnte im letzten pyrDown() eingebunden werden.
-
-    if (!in[last_in].empty()) {
-        /*
-        cv::Mat akt = in[first_in] (cv::Rect(geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1));
-        cv::Mat vor_akt = in[last_in] (cv::Rect(geo.left, geo.top, geo.right-geo.left+1, geo.bottom-geo.top+1));
-        cv::absdiff (akt, vor_akt, diff);      // Differenzbild berechnen => diff
-        */
-        cv::absdiff (in[first_in], in[last_in], diff);      // Differenzbild berechnen => diff
-
-        // schwelle (diff, properties.threshold);   // Ersetzt durch threshold. Siehe nächste Zeile
-        cv::threshold (diff, diff, properties.threshold, 255, THRESH_TOZERO);
-
-        anz_zero[first_in] = cv::countNonZero(diff);                        // Anzahl nonZero-Pixel in <diff> ermitteln.
-        properties.diff_non_zero = anz_zero[last_in] - anz_zero[first_in];  // Differenz zum Vorgängerbild berechnen.
-        if (abs(properties.diff_non_zero) >= properties.video_start_diff) { // Hat es eine groessere Differenz ergeben ?
-            properties.falle_aktiv = true;      // Bewegung erkannt. Video kann gestartet werden.
-            properties.frame_delay = MAX_DELAY;
+        int key = getch();
+        if ((key == 27) || (key == 'q'))
+            ende = 1;
+        if (key == 'h')
+            show_short_keys();
+        if (key == 'm') {
+            cout << ((cameras[0].run) ? "run inaktiv\n" : "run aktiv\n");
+            bool run = !cameras[0].run;
+            for (int i=0; i<anz_cameras; i++)
+                cameras[i].run = run;
+        }
+        if (key == 'i') {
+            show_properties ();
+            show_cam_stat ();
+        }
+        if (key == 'f') {
+            store.show ();              // ein Index für alle Kameras, durch einen Mutex geschützt
+            for (int i=0; i<anz_cameras; i++)
+                cameras[i].md.sv.show_fileliste();      // Fileliste ist durch einen Mutex geschützt
         }
     }
 
-    usleep (properties.frame_delay);     
-}
-
-/*! -------------------------------------------------
- * @brief state-machine kontrolliert den Videostream.
- *
- * Im wesentlichen werden Frameänderung und Framespeicherung abgearbeitet. \n
- * Im Idle-Mode werden Frameänderungen erkannt aber nicht gespeichert. \n
- * Gesteuert wird die state-machine durch die Variable @ref state.
- */
-static void control()
-{
-    char fname[512];
-    static char pic_name[512];
-    static int frame_counter = 0;       // Dient zum Zählen der abgespeicherten frames.
-    static int nachlauf_counter = 0;
-
-    get_frame();        // Bildeinzug und Bewegungserkennung. Wenn eine Bewegung erkannt wurde, wird <falle_aktiv> TRUE
-    switch (state) {
-        case 0: // --------------- idle - state ------------------
-            if (!properties.run) {      // ---- Überwachung ist NICHT inaktiv ----
-                if (properties.falle_aktiv) {
-                    static int n = 0;
-                    if (!properties.no_output) cout << " Bewegung erkannt(" << n << "): " << properties.diff_non_zero << endl;     // Anzeigen, das die Falle eine Bewegung erkannt hat !!!
-                    ++n;
-                    properties.falle_aktiv = false;
-                    properties.diff_non_zero = 0;
-                }
-                break;
-            } else {                    // ---- Überwachung ist aktiv ----
-                if (properties.falle_aktiv) {       // Falle ist aktiviert. Siehe <get_frame()>. 
-                    if (!properties.no_output) cout << "now: " << properties.diff_non_zero << endl;
-
-                    // int schwelle = 8000; 
-                    // const int schwelle = (int)((float)(back.cols * back.rows) * 0.41666666666);     // 41,6% von back
-                    const int schwelle = anz_sensetive_pixel * 0.41666666666;     // 41,6% von back
-                    int delta = schwelle + 1;
-
-                    if (!back.empty()) {    // es ist ein Hintergrundbild vorhanden !!!
-                        cv::Mat d;
-                        cv::absdiff (back, in[first_in], d);
-                        delta = cv::countNonZero ( d );         // Anzahl der NICHT schwarzen Pixel ermitteln.
-                        if (!properties.no_output) cout << "diff back-in " << delta << endl;
-                    }
-
-                    if (delta > schwelle) { 
-                        nachlauf_counter = 0;
-                        if (!back.empty())
-                            back.release();     // Hintergrundbild löschen
-
-                        timefunc::stop_timer ("CONTROL");
-                        state = 100;        // Aufnahme starten
-                    } else {
-                        properties.falle_aktiv = false;
-                        properties.diff_non_zero = 0;
-                    }
-                } else { 
-                    if (abs(properties.diff_non_zero) > 0) {         // noch keine aktive Falle aber es sind Differenz-Pixel vorhanden
-                        if (!properties.no_output) cout << properties.diff_non_zero << endl;
-                    } else {
-                        if (nachlauf_counter > 8)           // nach 8 Bilder mit <diff_non_zero == 0> wird der background festgehalten !!
-                            in[first_in].copyTo(back);      // save in[fist_in] at back-screen
-                        else 
-                            ++nachlauf_counter;
-                    } 
-                }
-            }
-            break;
-        case 100: {
-                // --------------- Dateiname berechnen ------------------
-                if (!properties.only_picture)                               // video Mode
-                    sprintf (fname, "%s/out%i.avi", folder.c_str(), vid_counter);   // Dateiname ermitteln
-                else {                                              // only picture Mode
-                    sprintf (fname, "%s/out_picture.avi", folder.c_str());  // Frame Dateiname ermitteln
-                    sprintf (pic_name, "%s/out%i.jpg", folder.c_str(), vid_counter);    // Picture Dateiname
-                }
-
-                ++vid_counter;
-
-                // ---------------- Video-Datei öffnen ----------------
-                // cv::Mat foo = make_ausgabe_screen(src[last_in], show_seg);  // Bildgroesse ermitteln
-                cv::Mat foo = make_ausgabe_screen(src_image, contours_pic);  // Bildgroesse ermitteln
-
-                bool ret = sv.open ( fname, foo.cols, foo.rows );   // Datei mit entsprechender Bildgroesse oeffnen !
-                if (!ret)
-                    cout << "cant open " << fname << endl;
-
-                frame_counter = 0;
-                state = 110;
-                timefunc::start_timer ("CONTROL");
-            }
-            break;
-        case 110: {
-                // ---------------- Bilder speichern -------------------
-                char buf[256];
-                sprintf (buf, "%i pix", abs(properties.diff_non_zero));
-
-                sv.write( make_ausgabe_screen(src_image, contours_pic),  &now[last_in], buf );     // Bild im Video ablegen !!!
-                cout << "." << flush;       // Fortschrittsanzeige
-                ++frame_counter;
-
-                if (properties.only_picture) {      // Bilder speichern
-                    if (frame_counter == 3) {
-                        // -------- Support for writing JPG ----------
-                        vector<int> compression_params;
-                        compression_params.push_back( cv::IMWRITE_JPEG_QUALITY );
-                        compression_params.push_back( 100 );
-                        // cv::Mat out (src[last_in]);
-                        cv::Mat out (src_image);
-                        if (sv.get_gray_flag() == true)
-                            cv::cvtColor (out, out, cv::COLOR_BGR2GRAY);               // Graustufenbild
-
-                        sv.write_date_to_pic (out, &now[last_in], buf);     // Zeit ins Bild schreiben
-                        cv::imwrite (pic_name, out, compression_params);    // save image
-                    }
-                }
-
-                if (properties.falle_aktiv) {
-                    if (timefunc::get_timer("CONTROL") >= properties.max_time) {    // max.Anzahl Bilder erreicht. 
-                                                                                    // Goto close Viedeo. 
-                                                                                    // Es findet kein Nachlauf statt !!!
-                        state = 130;                // Goto close Video
-                    }
-                } else if (timefunc::get_timer("CONTROL") > properties.min_time - (170 * properties.trail)) {    // Es ist keine Bewegung erkannt worden und 
-                                                    // die Anzahl der Bilder ist > 10. 
-                                                    // 10 Bilder benötigen ca. 1700 ms.
-                    nachlauf_counter = 0;
-                    state = 120;                    // Goto Video Nachlauf
-                }
-            }
-            break;
-        case 120: {  // ------------ video Nachlauf ca. 1200 ms ----------------------
-                char buf[256];
-                sprintf (buf, "%i pix", abs(properties.diff_non_zero));
-
-                sv.write ( make_ausgabe_screen(src_image, contours_pic),  &now[last_in], buf );     // Bild im Video ablegen !!!
-                cout << "." << flush;       // Fortschrittsanzeige
-                ++frame_counter;
-                ++nachlauf_counter;
-
-                if ((nachlauf_counter > properties.trail) || (timefunc::get_timer("CONTROL") > properties.max_time)) 
-                    state = 130;        // close video
-            }
-            break;
-        case 130:   // ------------------ close video --------------------------
-            sv.close();
-            cout << endl;
-            // cout << "Aufnahmedauer = " << timefunc::stop_timer("CONTROL") << " ms" << endl;
-            frame_counter = 0;
-            state = 0;
-            break;
+    cams_ende = true;
+    pool.stop ();               // laufende Schritte werden noch beendet
+    for (int i=0; i<anz_cameras; i++) {
+        cameras[i].md.finish ();                // offenes Video schliessen
+        cameras[i].grabber.stop ();
+        cameras[i].md.sv.stop_async ();         // Video-Warteschlange abarbeiten
     }
-}
-
-/*! ------------------------------------------------------------
- * @brief VideoCaptureProperties werden gelesen\n
- *        Vor dem lesen werden noch Bildbreite und Bildhöhe eingestellt.\n 
- * @see {@ref show_cam_para()}
- */
-static void get_cam_para ()
-{
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, camwidth);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, camheight);
-
-    // ------------------ Camera Parameter ----------------------------
-    cam_para.saturation = cap.get (cv::CAP_PROP_SATURATION);      // 1
-    cam_para.brightness = cap.get (cv::CAP_PROP_BRIGHTNESS);      // 0
-    cam_para.contrast = cap.get (cv::CAP_PROP_CONTRAST);          // 1
-    cam_para.exposure = cap.get (cv::CAP_PROP_EXPOSURE);          // 157
-    cam_para.fwidth = cap.get (cv::CAP_PROP_FRAME_WIDTH);
-    cam_para.fheight = cap.get (cv::CAP_PROP_FRAME_HEIGHT);
-}
-
-/*! ------------------------------------------------------------
- * @brief Ausgabe der VideoCaptureProperties
- * @see {@ref get_cam_para()}
- */
-static void show_cam_para ()
-{
-    cout << "--------- cam para ----------\n";
-    cout << "cam_para.saturation: " << cam_para.saturation << endl;
-    cout << "cam_para.brightness: " << cam_para.brightness << endl;
-    cout << "cam_para.contrast: " << cam_para.contrast << endl;
-    cout << "cam_para.exposure: " << cam_para.exposure << endl;
-    cout << "cam_para.fwidth: " << cam_para.fwidth << endl;
-    cout << "cam_para.fheight: " << cam_para.fheight << endl;
+    store.stop ();              // letzte Videos eintragen, Index schreiben
+    show_cam_stat ();
+    for (int i=0; i<anz_cameras; i++) {
+        cout << "cam " << cameras[i].cam_index << ": ";
+        cameras[i].grabber.show_stat ();
+        cameras[i].md.sv.show_stat ();
+    }
+    return 0;
 }
 
 /*! ------------------------------------------------------------
@@ -1473,98 +1518,131 @@ int main (int argc, char ** argv)
     init_keyboard ();           // wird für kbhit() benötigt !
     get_homedir();              // Home Verzeichnis ermitteln.
     init_folder();              // Pfad für Video-Speicherung einrichten.
-    init_vid_counter();         // Video-Nr ermitteln !
-
-    if (!properties.no_output) {
+    sv_encoder::probe (codec, md.folder);   // H.264, wenn vorhanden. Sonst MJPG.
+    md.sv.set_codec (codec);
+    md.sv.set_sidecar (md.properties.record == RECORD_RAW);    // raw: Zeitstempel und Blobs als Untertitel
+    if (store.open (video_root, quota_mb, minfree_mb))     // Index aller Tage, Quota
+        md.sv.set_storage (&store);
+    if (cams.size() > 1) {      // mehrere Kameras: eine Pipeline je Kamera auf dem worker_pool
+        int ret = run_cameras ();
+        close_keyboard ();
+        return ret;
+    }
+    if (md.properties.threads > 1)
+        cv::setNumThreads (md.properties.threads);      // einmal beim Start: gilt prozessweit, nie je Bild
+    md.init_vid_counter();      // Video-Nr ermitteln !
+    if (!md.properties.only_picture)
+        md.sv.set_preroll (md.properties.preroll, md.properties.preroll_mem);    // Bilder vor dem Auslösen puffern
+    if (md.properties.replay)
+        md.properties.vid_policy = SV_BLOCK;    // Replay: kein Bild verwerfen, der Encoder bremst die Auswertung
+    md.sv.set_async (md.properties.vid_queue, md.properties.vid_policy);     // Video-Encoder im Hintergrund
+
+    if (!md.properties.no_output) {
         cout << "version: " << VERSION << endl;
-        cout << "Camera Index: " << properties.cam_index << endl;
+        cout << "Camera Index: " << md.properties.cam_index << endl;
     }
 
     // -------------- create win-name ------------------------
     char src_win_name[256];
     sprintf (src_win_name, "%s %s", "src_image", VERSION);  // Text für Window Titelleiste
 
-    if (!properties.no_output) {
+    if (!md.properties.no_output) {
         cv::namedWindow("diff_image");
-        cv::namedWindow(src_win_name);      // Fenster für src[first_in]
+        cv::namedWindow(src_win_name);      // Fenster für src_image
         // cv::namedWindow("Harris");
         // cv::namedWindow("back_image");
     }
 
-    // cap = new cv::VideoCapture ( properties.cam_index );
-    cap.open ( properties.cam_index, cv::CAP_V4L2 );
-
-    if(!cap.isOpened()) {           // check if we succeeded
-        cout << "NO CAMERA\n";
+    if (md.properties.replay) {
+        if (!grabber.open_file (input_path)) {
+            cout << "ERROR cant open " << input_path << endl;
+            return -1;
+        }
+    } else if (!open_camera (grabber, md.properties.cam_index, pixfmt))
         return -1;
-    }
 
-    get_cam_para ();
-    reset_geo ();
+    if (!csv_path.empty() && !md.open_csv (csv_path))
+        cout << "ERROR cant open " << csv_path << endl;
+
+    get_cam_para (grabber);
+    md.reset_geo (new_geo, cam_para.fwidth, cam_para.fheight);
+    md.set_source (&grabber);
+    grabber.start ();           // ab hier gehört die Kamera dem Grabber-Thread
 
     show_geo ();
     show_short_keys ();
     show_cam_para ();
 
     // ------------------- Bildeinzug initialisieren --------------------
-    while (diff.empty())    
-        get_frame();
+    while (!md.is_ready() && !grabber.is_eof())    
+        md.get_frame();
 
     // -------------- Verweilzeit -------------------------------------
-    for (int i=0; i<10; i++) {
-        get_frame();
-        cout << "+" << flush;
+    if (!md.properties.replay) {
+        for (int i=0; i<10; i++) {
+            md.get_frame();
+            cout << "+" << flush;
+        }
+        cout << endl;
     }
-    cout << endl;
 
-    check_pixdiff ();   // OPTION --pixdiff checken
+    md.check_pixdiff ();    // OPTION --pixdiff checken
 
-    anz_sensetive_pixel = get_anzahl_sensetive_pixel();
-    cout << "anz_sensetive_pixel = " << anz_sensetive_pixel << endl;
+    md.anz_sensetive_pixel = md.get_anzahl_sensetive_pixel();
+    cout << "anz_sensetive_pixel = " << md.anz_sensetive_pixel << endl;
 
     int key = -1;
     int ende = 0;
+    uint64_t replay_frames = 0;
+    timefunc::start_timer ("REPLAY");
     while (!ende) {
-        control();      // Betriebszustände überwachen.
+        if (md.control())   // Betriebszustände überwachen.
+            ++replay_frames;
+        else if (grabber.is_eof())
+            break;          // Replay: alle Bilder ausgewertet
 
         // ----------------- Bildausgabe ------------------------
-        if (!properties.no_output) {
-            if (!diff.empty()) {
-                write_diff_non_zero_to_diff ();
-                cv::imshow ("diff_image", diff);
+        if (!md.properties.no_output) {
+            if (!md.get_diff().empty()) {
+                md.write_diff_non_zero_to_diff ();
+                cv::imshow ("diff_image", md.get_diff());
             }
 
+            cv::Mat &src_image = md.get_src_image();
             if (!src_image.empty()) {
                 cv::rectangle (src_image, // src[first_in], 
-                               cv::Point (geo.left, geo.top), cv::Point (geo.right, geo.bottom),
+                               cv::Point (md.geo.left, md.geo.top), cv::Point (md.geo.right, md.geo.bottom),
                                cv::Scalar(0, 255, 0),       // green
                                2);
                 cv::imshow (src_win_name, src_image);
             }
 
             #ifdef SHOW_MOSAIK
-            if (!show_seg.empty())
-                cv::imshow("Mosaik", show_seg);
+            if (!md.get_show_seg().empty())
+                cv::imshow("Mosaik", md.get_show_seg());
             #endif
 
             #ifdef USE_HARRIS_DETECTOR
-            if (!harrisCorners.empty())
-                cv::imshow("Harris", harrisCorners);
+            if (!md.get_harris_corners().empty())
+                cv::imshow("Harris", md.get_harris_corners());
             #endif
 
-            if (!contours_pic.empty())
-                cv::imshow("contours", contours_pic);
+            if (!md.get_contours_pic().empty())
+                cv::imshow("contours", md.get_contours_pic());
 
             // ------------------- back image ----------------------
-            if (!back.empty())
-                cv::imshow ("back_image", back);
+            if (!md.get_back().empty())
+                cv::imshow ("back_image", md.get_back());
             // ---- destroyWindow funktioniert nicht auf dem raspi -----
             /* else 
                 cv::destroyWindow("back_image"); */
         }
 
         // --------------- Tastatur abfragen ------------------------
-        if ((key = cv::waitKey(10)) == -1) {    // key im opencv-window abfragen.
+        key = -1;
+        if (!(md.properties.replay && md.properties.no_output))     // Replay ohne Fenster: nicht warten
+            key = cv::waitKey((md.properties.replay) ? 1 : 10);     // key im opencv-window abfragen.
+        if (key == -1) {
             if (kbhit()) {                      // key im terminal abfragen.
                 key = getch();
             }
@@ -1576,18 +1654,37 @@ int main (int argc, char ** argv)
         if (key == 'h')
             show_short_keys();
         if (key == 'm') {
-            cout << ((properties.run) ? "run inaktiv\n" : "run aktiv\n");
-            properties.run = !properties.run;
+            cout << ((md.properties.run) ? "run inaktiv\n" : "run aktiv\n");
+            md.properties.run = !md.properties.run;
         }
         if (key == 'i') {
             show_properties ();       // properties anzeigen
             show_geo ();        // struct _geo_ anzeigen.
             show_cam_para ();   // Camera Parameter
+            grabber.show_stat ();   // captured / dropped frames
+            md.sv.show_stat ();        // Video-Warteschlange
+        }
+        if (key == 'f') {
+            store.show ();              // Index aller Tage
+            md.sv.show_fileliste();     // Videos dieses Laufs (--maxvideo)
         }
-        if (key == 'f')
-            sv.show_fileliste();
     }
 
+    grabber.stop ();
+    if (md.properties.replay) {
+        md.finish ();     // offenes Video schliessen
+        int ms = timefunc::stop_timer ("REPLAY");
+        cout << "replay: " << replay_frames << " frames in " << ms << " ms";
+        if (ms > 0)
+            cout << " = " << (replay_frames * 1000.0 / ms) << " fps";
+        cout << endl;
+    }
+#ifndef NDEBUG
+    cout << "frame_ctx: " << md.get_ctx_allocs() << " Puffer nach dem Aufwärmen neu angelegt" << endl;
+#endif
+    md.sv.stop_async ();           // Video-Warteschlange abarbeiten
+    store.stop ();                 // letzte Videos eintragen, Index schreiben
+    md.close_csv ();
     close_keyboard ();
     return 0;
 }
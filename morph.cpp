@@ -0,0 +1,206 @@
+/*! ------------------------------------------
+ * @addtogroup morph
+ * @{
+ *
+ * @file    morph.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref morph.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "morph.hpp"
+
+#ifndef MORPH_SCALAR
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define MORPH_AVX2
+    #elif defined(__SSE2__)
+        #include <emmintrin.h>
+        #define MORPH_SSE2
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>
+        #define MORPH_NEON
+    #endif
+#endif
+
+/*! -------------------------------
+ * @brief Maximum für dilate()
+ */
+struct _op_max_ {
+    static inline uint8_t op (uint8_t a, uint8_t b) { return (a > b) ? a : b; }
+#if defined(MORPH_AVX2)
+    static inline __m256i op (__m256i a, __m256i b) { return _mm256_max_epu8 (a, b); }
+#elif defined(MORPH_SSE2)
+    static inline __m128i op (__m128i a, __m128i b) { return _mm_max_epu8 (a, b); }
+#elif defined(MORPH_NEON)
+    static inline uint8x16_t op (uint8x16_t a, uint8x16_t b) { return vmaxq_u8 (a, b); }
+#endif
+};
+
+/*! -------------------------------
+ * @brief Minimum für erode()
+ */
+struct _op_min_ {
+    static inline uint8_t op (uint8_t a, uint8_t b) { return (a < b) ? a : b; }
+#if defined(MORPH_AVX2)
+    static inline __m256i op (__m256i a, __m256i b) { return _mm256_min_epu8 (a, b); }
+#elif defined(MORPH_SSE2)
+    static inline __m128i op (__m128i a, __m128i b) { return _mm_min_epu8 (a, b); }
+#elif defined(MORPH_NEON)
+    static inline uint8x16_t op (uint8x16_t a, uint8x16_t b) { return vminq_u8 (a, b); }
+#endif
+};
+
+/*! ----------------------------------------------
+ * @brief d[i] = OP(a[i], b[i]) für eine ganze Zeile. SIMD, Rest skalar.
+ */
+template <class OP>
+static inline void op_row (const uint8_t *a, const uint8_t *b, uint8_t *d, int n)
+{
+    int i = 0;
+#if defined(MORPH_AVX2)
+    for (; i + 32 <= n; i += 32)
+        _mm256_storeu_si256 ((__m256i *)(d + i), OP::op (_mm256_loadu_si256 ((const __m256i *)(a + i)),
+                                                         _mm256_loadu_si256 ((const __m256i *)(b + i))));
+#elif defined(MORPH_SSE2)
+    for (; i + 16 <= n; i += 16)
+        _mm_storeu_si128 ((__m128i *)(d + i), OP::op (_mm_loadu_si128 ((const __m128i *)(a + i)),
+                                                      _mm_loadu_si128 ((const __m128i *)(b + i))));
+#elif defined(MORPH_NEON)
+    for (; i + 16 <= n; i += 16)
+        vst1q_u8 (d + i, OP::op (vld1q_u8 (a + i), vld1q_u8 (b + i)));
+#endif
+    for (; i < n; i++)
+        d[i] = OP::op (a[i], b[i]);
+}
+
+/*! ----------------------------------------------
+ * @brief Eine Zeile filtern (van Herk / Gil-Werman).\n
+ *        Die Zeile wird links und rechts um r Pixel mit dem Randwert verlängert (p, Länge n + 2r).
+ *        g: Präfix je Block der Länge w = 2r+1, h: Suffix je Block. Ergebnis d[x] = OP(h[x], g[x + 2r]).
+ * @param p, g, h Arbeitspuffer mit n + 2r Werten
+ */
+template <class OP>
+static void filter_row (const uint8_t *s, uint8_t *d, int n, int r, uint8_t *p, uint8_t *g, uint8_t *h)
+{
+    const int w = 2 * r + 1;
+    const int len = n + 2 * r;
+
+    for (int i=0; i<r; i++) {
+        p[i] = s[0];
+        p[r + n + i] = s[n - 1];
+    }
+    for (int i=0; i<n; i++)
+        p[r + i] = s[i];
+
+    for (int i=0; i<len; i++)
+        g[i] = (i % w == 0) ? p[i] : OP::op (g[i - 1], p[i]);
+    h[len - 1] = p[len - 1];
+    for (int i=len-2; i>=0; i--)
+        h[i] = ((i + 1) % w == 0) ? p[i] : OP::op (h[i + 1], p[i]);
+
+    for (int x=0; x<n; x++)
+        d[x] = OP::op (h[x], g[x + 2 * r]);
+}
+
+/*! ----------------------------------------------
+ * @brief Rechteckiges Fenster (2r+1) x (2r+1): erst alle Zeilen, dann die Spalten.\n
+ *        Die Spalten werden wie eine Zeile gefiltert, nur dass jedes Element eine ganze Bildzeile ist.
+ *        Die Arbeitspuffer bleiben über die Aufrufe erhalten.
+ */
+template <class OP>
+static void filter (const cv::Mat &src, cv::Mat &dst, int r)
+{
+    CV_Assert (src.type() == CV_8UC1 && r >= 0 && src.data != dst.data);
+
+    dst.create (src.rows, src.cols, CV_8UC1);
+    if (r == 0) {
+        src.copyTo (dst);
+        return;
+    }
+
+    const int rows = src.rows;
+    const int cols = src.cols;
+    const int w = 2 * r + 1;
+    const int len = rows + 2 * r;
+
+    static thread_local std::vector<uint8_t> line;      // p, g, h einer Zeile
+    static thread_local cv::Mat tmp;                    // Ergebnis der Zeilen
+    static thread_local cv::Mat G, H;                   // Präfix und Suffix der Spalten, len Zeilen
+    line.resize (3 * (cols + 2 * r));
+    tmp.create (rows, cols, CV_8UC1);
+    G.create (len, cols, CV_8UC1);
+    H.create (len, cols, CV_8UC1);
+
+    // ---------------- Zeilen ----------------
+    uint8_t *p = line.data();
+    for (int y=0; y<rows; y++)
+        filter_row<OP> (src.ptr<uint8_t>(y), tmp.ptr<uint8_t>(y), cols, r, p, p + cols + 2*r, p + 2 * (cols + 2*r));
+
+    // ---------------- Spalten ----------------
+    // Zeile i der verlängerten Spalte ist tmp-Zeile clamp(i - r)
+    auto P = [&](int i) { return tmp.ptr<uint8_t>(std::min (std::max (i - r, 0), rows - 1)); };
+
+    for (int i=0; i<len; i++) {
+        if (i % w == 0)
+            memcpy (G.ptr<uint8_t>(i), P(i), cols);
+        else
+            op_row<OP> (G.ptr<uint8_t>(i - 1), P(i), G.ptr<uint8_t>(i), cols);
+    }
+    memcpy (H.ptr<uint8_t>(len - 1), P(len - 1), cols);
+    for (int i=len-2; i>=0; i--) {
+        if ((i + 1) % w == 0)
+            memcpy (H.ptr<uint8_t>(i), P(i), cols);
+        else
+            op_row<OP> (H.ptr<uint8_t>(i + 1), P(i), H.ptr<uint8_t>(i), cols);
+    }
+
+    for (int y=0; y<rows; y++)
+        op_row<OP> (H.ptr<uint8_t>(y), G.ptr<uint8_t>(y + 2 * r), dst.ptr<uint8_t>(y), cols);
+}
+
+/*! ----------------------------------------------
+ * @brief Maximum im Fenster (2r+1) x (2r+1). Wie cv::dilate() mit 3x3-Kern, r Iterationen und BORDER_REPLICATE.
+ * @param src Graubild CV_8UC1
+ * @param dst Ergebnis. Darf nicht src sein. Wird nur bei geänderter Grösse neu angelegt.
+ * @param r Radius, z.B. 6 für 13 x 13
+ */
+void morph::dilate (const cv::Mat &src, cv::Mat &dst, int r)
+{
+    filter<_op_max_> (src, dst, r);
+}
+
+/*! ----------------------------------------------
+ * @brief Minimum im Fenster (2r+1) x (2r+1). Wie cv::erode() mit 3x3-Kern, r Iterationen und BORDER_REPLICATE.
+ * @param src Graubild CV_8UC1
+ * @param dst Ergebnis. Darf nicht src sein. Wird nur bei geänderter Grösse neu angelegt.
+ * @param r Radius, z.B. 6 für 13 x 13
+ */
+void morph::erode (const cv::Mat &src, cv::Mat &dst, int r)
+{
+    filter<_op_min_> (src, dst, r);
+}
+
+/*! ----------------------------------------------
+ * @brief Name des übersetzten Pfades für den Spaltendurchlauf.
+ */
+const char *morph::simd_name ()
+{
+#if defined(MORPH_AVX2)
+    return "AVX2";
+#elif defined(MORPH_SSE2)
+    return "SSE2";
+#elif defined(MORPH_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+//! @} morph
@@ -0,0 +1,41 @@
+/*! ------------------------------------------
+ * @defgroup morph Morph: dilate und erode in O(1) je Pixel
+ * @{
+ *
+ * @file    morph.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Rechteckiges dilate() / erode() nach van Herk / Gil-Werman.\n
+ * Der Aufwand je Pixel hängt nicht von der Fenstergrösse ab: je Richtung ein Präfix-, ein Suffix-Maximum
+ * und ein Vergleich. Gefiltert wird separabel, erst die Zeilen, dann die Spalten.
+ * Der Spaltendurchlauf arbeitet zeilenweise mit AVX2, SSE2 oder NEON (-DMORPH_SCALAR: nur skalar).\n
+ * Der Rand wird wie bei BORDER_REPLICATE behandelt. Das Ergebnis entspricht damit
+ * cv::dilate(src, dst, Mat(), Point(-1, -1), r, BORDER_REPLICATE) mit 3x3-Kern und r Iterationen.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef MORPH_HPP
+#define MORPH_HPP
+
+#include <stdint.h>
+
+#include "opencv2/opencv.hpp"
+
+#define MORPH_OPENCV 0          //!< cv::dilate() / cv::erode() mit Iterationen. Option --morph cv
+#define MORPH_VHGW 1            //!< @ref morph::dilate() / @ref morph::erode(). Option --morph vhgw
+
+/*! -------------------------------
+ * @brief Morphologie mit rechteckigem Fenster (2r+1) x (2r+1). Alle Funktionen sind static.
+ */
+class morph {
+public:
+    static void dilate (const cv::Mat &src, cv::Mat &dst, int r);
+    static void erode (const cv::Mat &src, cv::Mat &dst, int r);
+
+    static const char *simd_name ();
+};
+
+#endif
+
+//! @} morph
@@ -0,0 +1,261 @@
+/*! ------------------------------------------
+ * @addtogroup pixdiff
+ * @{
+ *
+ * @file    pixdiff.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Implementierung der class @ref pixdiff.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <vector>
+
+#include "pixdiff.hpp"
+
+#ifndef PIXDIFF_SCALAR
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+        #define PIXDIFF_AVX2
+    #elif defined(__SSE2__)
+        #include <emmintrin.h>
+        #define PIXDIFF_SSE2
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>
+        #define PIXDIFF_NEON
+    #endif
+#endif
+
+/*! ----------------------------------------------
+ * @brief Skalarer Pfad. Zählt die Pixel mit |a[i] - b[i]| > thr.
+ * @param dst Differenzbild wie cv::threshold(THRESH_TOZERO). Darf NULL sein.
+ * @param n Anzahl Pixel
+ * @return Anzahl Pixel über der Schwelle
+ */
+int pixdiff::row_scalar (const uint8_t *a, const uint8_t *b, uint8_t *dst, int n, uint8_t thr)
+{
+    int cnt = 0;
+
+    for (int i=0; i<n; i++) {
+        uint8_t d = (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i];
+        bool over = (d > thr);
+        cnt += over;
+        if (dst != NULL)
+            dst[i] = over ? d : 0;
+    }
+    return cnt;
+}
+
+/*! ----------------------------------------------
+ * @brief Zählt die Pixel mit |a[i] - b[i]| > thr. SIMD, Rest skalar.
+ * @param dst Differenzbild wie cv::threshold(THRESH_TOZERO). Darf NULL sein.
+ * @param n Anzahl Pixel
+ * @return Anzahl Pixel über der Schwelle
+ */
+int pixdiff::row (const uint8_t *a, const uint8_t *b, uint8_t *dst, int n, uint8_t thr)
+{
+    int i = 0;
+    int cnt = 0;
+
+#if defined(PIXDIFF_AVX2)
+    const __m256i t = _mm256_set1_epi8 ((char)thr);
+    const __m256i zero = _mm256_setzero_si256 ();
+    while (i + 32 <= n) {
+        __m256i acc = zero;                 // 8-Bit Zähler. Max. 255 Durchläufe bis zum Aufsummieren.
+        int end = i + 32 * 255;
+        if (end > n) end = n;
+        for (; i + 32 <= end; i += 32) {
+            __m256i va = _mm256_loadu_si256 ((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256 ((const __m256i *)(b + i));
+            __m256i d = _mm256_or_si256 (_mm256_subs_epu8 (va, vb), _mm256_subs_epu8 (vb, va));
+            __m256i le = _mm256_cmpeq_epi8 (_mm256_subs_epu8 (d, t), zero);    // 0xFF: d <= thr
+            acc = _mm256_sub_epi8 (acc, _mm256_xor_si256 (le, _mm256_set1_epi8 (-1)));
+            if (dst != NULL)
+                _mm256_storeu_si256 ((__m256i *)(dst + i), _mm256_andnot_si256 (le, d));
+        }
+        __m256i s = _mm256_sad_epu8 (acc, zero);
+        cnt += _mm256_extract_epi64 (s, 0) + _mm256_extract_epi64 (s, 1) +
+               _mm256_extract_epi64 (s, 2) + _mm256_extract_epi64 (s, 3);
+    }
+#elif defined(PIXDIFF_SSE2)
+    const __m128i t = _mm_set1_epi8 ((char)thr);
+    const __m128i zero = _mm_setzero_si128 ();
+    while (i + 16 <= n) {
+        __m128i acc = zero;                 // 8-Bit Zähler. Max. 255 Durchläufe bis zum Aufsummieren.
+        int end = i + 16 * 255;
+        if (end > n) end = n;
+        for (; i + 16 <= end; i += 16) {
+            __m128i va = _mm_loadu_si128 ((const __m128i *)(a + i));
+            __m128i vb = _mm_loadu_si128 ((const __m128i *)(b + i));
+            __m128i d = _mm_or_si128 (_mm_subs_epu8 (va, vb), _mm_subs_epu8 (vb, va));
+            __m128i le = _mm_cmpeq_epi8 (_mm_subs_epu8 (d, t), zero);          // 0xFF: d <= thr
+            acc = _mm_sub_epi8 (acc, _mm_xor_si128 (le, _mm_set1_epi8 (-1)));
+            if (dst != NULL)
+                _mm_storeu_si128 ((__m128i *)(dst + i), _mm_andnot_si128 (le, d));
+        }
+        __m128i s = _mm_sad_epu8 (acc, zero);
+        cnt += _mm_cvtsi128_si32 (s) + _mm_cvtsi128_si32 (_mm_srli_si128 (s, 8));
+    }
+#elif defined(PIXDIFF_NEON)
+    const uint8x16_t t = vdupq_n_u8 (thr);
+    while (i + 16 <= n) {
+        uint8x16_t acc = vdupq_n_u8 (0);    // 8-Bit Zähler. Max. 255 Durchläufe bis zum Aufsummieren.
+        int end = i + 16 * 255;
+        if (end > n) end = n;
+        for (; i + 16 <= end; i += 16) {
+            uint8x16_t d = vabdq_u8 (vld1q_u8 (a + i), vld1q_u8 (b + i));
+            uint8x16_t over = vcgtq_u8 (d, t);                                  // 0xFF: d > thr
+            acc = vsubq_u8 (acc, over);
+            if (dst != NULL)
+                vst1q_u8 (dst + i, vandq_u8 (d, over));
+        }
+        uint64x2_t s = vpaddlq_u32 (vpaddlq_u16 (vpaddlq_u8 (acc)));
+        cnt += (int)(vgetq_lane_u64 (s, 0) + vgetq_lane_u64 (s, 1));
+    }
+#endif
+
+    if (i < n)
+        cnt += row_scalar (a + i, b + i, (dst != NULL) ? dst + i : NULL, n - i, thr);
+    return cnt;
+}
+
+/*! ----------------------------------------------
+ * @brief Ersetzt absdiff(), threshold(THRESH_TOZERO) und countNonZero() für das ganze Bild.
+ * @param a, b Graubilder (CV_8UC1) gleicher Grösse
+ * @param thr Schwelle. Gezählt wird |a - b| > thr.
+ * @param dst Differenzbild. Wird nur geschrieben, wenn dst != NULL.
+ * @return Anzahl Pixel über der Schwelle
+ */
+int pixdiff::count (const cv::Mat &a, const cv::Mat &b, uint8_t thr, cv::Mat *dst)
+{
+    CV_Assert (a.type() == CV_8UC1 && b.type() == CV_8UC1 && a.size() == b.size());
+
+    if (dst != NULL)
+        dst->create (a.rows, a.cols, CV_8UC1);
+
+    int cnt = 0;
+    for (int y=0; y<a.rows; y++)
+        cnt += row (a.ptr<uint8_t>(y), b.ptr<uint8_t>(y),
+                    (dst != NULL) ? dst->ptr<uint8_t>(y) : NULL, a.cols, thr);
+    return cnt;
+}
+
+/*! ----------------------------------------------
+ * @brief Feldgrenzen: Feld i geht von edge[i] bis edge[i+1]-1.\n
+ *        Der Rest der Teilung wird gleichmässig auf die Felder verteilt; es wird kein Pixel ignoriert.
+ * @param len Bildbreite bzw. Bildhöhe
+ * @param n Anzahl Felder
+ * @param edge n+1 Werte
+ */
+void pixdiff::tile_edges (int len, int n, int *edge)
+{
+    for (int i=0; i<=n; i++)
+        edge[i] = (int)((long)i * len / n);
+}
+
+/*! ----------------------------------------------
+ * @brief Ein Durchlauf über die Feldzeilen ty0 .. ty1-1. TX > 0: Anzahl Felder in X steht zur Compile-Zeit fest,
+ *        die innere Schleife wird vom Compiler aufgerollt. TX = 0: beliebige Anzahl tiles_x.
+ */
+template <int TX>
+static void tile_rows (const cv::Mat &a, const cv::Mat &b, int tiles_x, int ty0, int ty1,
+                       const int *xe, const int *ye, uint8_t thr, int *counts)
+{
+    const int nx = (TX > 0) ? TX : tiles_x;
+
+    for (int ty=ty0; ty<ty1; ty++) {
+        int *c = counts + ty * nx;
+        for (int y=ye[ty]; y<ye[ty+1]; y++) {
+            const uint8_t *pa = a.ptr<uint8_t>(y);
+            const uint8_t *pb = b.ptr<uint8_t>(y);
+            for (int tx=0; tx<nx; tx++)
+                c[tx] += pixdiff::row (pa + xe[tx], pb + xe[tx], NULL, xe[tx+1] - xe[tx], thr);
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Feldzeilen in Bändern auf threads Threads verteilen (cv::parallel_for_).\n
+ *        Jedes Feld wird von genau einem Band gezählt, in derselben Reihenfolge wie seriell.
+ *        Das Ergebnis ist also unabhängig von der Anzahl Threads.\n
+ *        threads legt die Anzahl Bänder fest (nstripes). Die Anzahl Threads ist die von cv::setNumThreads();
+ *        main() stellt sie beim Start einmal aus --threads ein, hier wird sie nie verändert.
+ */
+template <int TX>
+static void tile_bands (const cv::Mat &a, const cv::Mat &b, int tiles_x, int tiles_y,
+                        const int *xe, const int *ye, uint8_t thr, int *counts, int threads)
+{
+    if ((threads == 1) || (tiles_y < 2)) {
+        tile_rows<TX> (a, b, tiles_x, 0, tiles_y, xe, ye, thr, counts);
+        return;
+    }
+
+    cv::parallel_for_ (cv::Range (0, tiles_y), [&](const cv::Range &r) {
+        tile_rows<TX> (a, b, tiles_x, r.start, r.end, xe, ye, thr, counts);
+    }, (threads > 1) ? threads : -1);
+}
+
+/*! ----------------------------------------------
+ * @brief Feste Mosaik-Grösse TX x TY. Die Feldgrenzen liegen auf dem Stack.
+ */
+template <int TX, int TY>
+static void tiles_fixed (const cv::Mat &a, const cv::Mat &b, uint8_t thr, int *counts, int threads)
+{
+    int xe[TX+1], ye[TY+1];
+    pixdiff::tile_edges (a.cols, TX, xe);
+    pixdiff::tile_edges (a.rows, TY, ye);
+    tile_bands<TX> (a, b, TX, TY, xe, ye, thr, counts, threads);
+}
+
+/*! ----------------------------------------------
+ * @brief Zählt die Pixel über der Schwelle je Mosaik-Feld. Ein Durchlauf über beide Bilder.\n
+ *        Die Feldgrenzen kommen aus @ref tile_edges(); die Felder am Rand sind eingeschlossen.\n
+ *        Für 8x6, 16x12 und 32x24 gibt es eine eigene, zur Compile-Zeit spezialisierte Variante.
+ * @param a, b Graubilder (CV_8UC1) gleicher Grösse
+ * @param tiles_x, tiles_y Anzahl Felder. Max. Bildbreite bzw. Bildhöhe.
+ * @param counts Ergebnis, tiles_x * tiles_y Werte, zeilenweise: counts[ty * tiles_x + tx]
+ * @param threads Feldzeilen in Bändern parallel zählen. 1 = seriell, 0 = alle Threads von OpenCV.
+ *        Das Ergebnis hängt nicht von threads ab.
+ */
+void pixdiff::tiles (const cv::Mat &a, const cv::Mat &b, int tiles_x, int tiles_y, uint8_t thr, int *counts, int threads)
+{
+    CV_Assert (a.type() == CV_8UC1 && b.type() == CV_8UC1 && a.size() == b.size());
+    CV_Assert (tiles_x > 0 && tiles_y > 0 && tiles_x <= a.cols && tiles_y <= a.rows);
+
+    for (int i=0; i<tiles_x*tiles_y; i++)
+        counts[i] = 0;
+
+    if ((tiles_x == 8) && (tiles_y == 6))
+        tiles_fixed<8, 6> (a, b, thr, counts, threads);
+    else if ((tiles_x == 16) && (tiles_y == 12))
+        tiles_fixed<16, 12> (a, b, thr, counts, threads);
+    else if ((tiles_x == 32) && (tiles_y == 24))
+        tiles_fixed<32, 24> (a, b, thr, counts, threads);
+    else {
+        static thread_local std::vector<int> xe, ye;     // Feldgrenzen. Die Kapazität bleibt erhalten: keine Allokation je Bild.
+        xe.resize (tiles_x + 1);
+        ye.resize (tiles_y + 1);
+        tile_edges (a.cols, tiles_x, xe.data());
+        tile_edges (a.rows, tiles_y, ye.data());
+        tile_bands<0> (a, b, tiles_x, tiles_y, xe.data(), ye.data(), thr, counts, threads);
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Name des übersetzten Pfades, z.B. für die Ausgabe im Benchmark.
+ */
+const char *pixdiff::simd_name ()
+{
+#if defined(PIXDIFF_AVX2)
+    return "AVX2";
+#elif defined(PIXDIFF_SSE2)
+    return "SSE2";
+#elif defined(PIXDIFF_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+//! @} pixdiff
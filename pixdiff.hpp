@@ -0,0 +1,42 @@
+/*! ------------------------------------------
+ * @defgroup pixdiff Pixdiff: Differenzpixel zählen
+ * @{
+ *
+ * @file    pixdiff.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Kernel zählt in einem Durchlauf alle Pixel mit |a - b| > Schwelle.\n
+ * Ersetzt die Folge cv::absdiff(), cv::threshold(THRESH_TOZERO) und cv::countNonZero()
+ * für das ganze Bild und für jedes Mosaik-Feld. Das Differenzbild wird nur geschrieben, wenn es gebraucht wird.
+ * Die Mosaik-Felder lassen sich in Bändern auf mehrere Threads verteilen (Option --threads).\n
+ * Je nach Compiler-Flags wird AVX2, SSE2 oder NEON verwendet. Mit -DPIXDIFF_SCALAR wird nur der
+ * skalare Pfad übersetzt. Der skalare Pfad @ref pixdiff::row_scalar() dient auch zur Kontrolle.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef PIXDIFF_HPP
+#define PIXDIFF_HPP
+
+#include <stdint.h>
+
+#include "opencv2/opencv.hpp"
+
+/*! -------------------------------
+ * @brief Differenzpixel zählen. Alle Funktionen sind static.
+ */
+class pixdiff {
+public:
+    static int row (const uint8_t *a, const uint8_t *b, uint8_t *dst, int n, uint8_t thr);
+    static int row_scalar (const uint8_t *a, const uint8_t *b, uint8_t *dst, int n, uint8_t thr);
+
+    static int count (const cv::Mat &a, const cv::Mat &b, uint8_t thr, cv::Mat *dst = NULL);
+    static void tiles (const cv::Mat &a, const cv::Mat &b, int tiles_x, int tiles_y, uint8_t thr, int *counts, int threads = 1);
+    static void tile_edges (int len, int n, int *edge);
+
+    static const char *simd_name ();
+};
+
+#endif
+
+//! @} pixdiff
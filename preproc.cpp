@@ -0,0 +1,129 @@
+/*! ------------------------------------------
+ * @addtogroup preproc
+ * @{
+ *
+ * @file    preproc.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref preproc.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "preproc.hpp"
+
+// Gewichte wie cv::COLOR_BGR2GRAY (Fixpunkt, Summe = 1 << 14)
+#define GRAY_B 1868
+#define GRAY_G 9617
+#define GRAY_R 4899
+
+/*! ----------------------------------------------
+ * @brief BGR => Grau, halbe Grösse. Ein Zielpixel ist das Mittel aus 2x2 Quellpixeln.\n
+ *        Die 4 Farbwerte je Kanal werden erst summiert und dann einmal gewichtet und gerundet.
+ * @param bgr BGR-Bild CV_8UC3. Darf ein ROI sein (nicht zusammenhängend).
+ * @param dst Ergebnis CV_8UC1, bgr.cols/2 x bgr.rows/2. Wird nur bei geänderter Grösse neu angelegt.
+ */
+void preproc::gray_half (const cv::Mat &bgr, cv::Mat &dst)
+{
+    CV_Assert (bgr.type() == CV_8UC3 && bgr.cols >= 2 && bgr.rows >= 2);
+
+    const int w = bgr.cols / 2;
+    const int h = bgr.rows / 2;
+    dst.create (h, w, CV_8UC1);
+
+    for (int y=0; y<h; y++) {
+        const uint8_t *s0 = bgr.ptr<uint8_t>(2 * y);
+        const uint8_t *s1 = bgr.ptr<uint8_t>(2 * y + 1);
+        uint8_t *d = dst.ptr<uint8_t>(y);
+        for (int x=0; x<w; x++, s0 += 6, s1 += 6) {
+            int b = s0[0] + s0[3] + s1[0] + s1[3];
+            int g = s0[1] + s0[4] + s1[1] + s1[4];
+            int r = s0[2] + s0[5] + s1[2] + s1[5];
+            d[x] = (uint8_t)((b * GRAY_B + g * GRAY_G + r * GRAY_R + (1 << 15)) >> 16);
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief YUYV => Grau, halbe Grösse. Gelesen wird nur Y; ein Zielpixel ist das Mittel aus 2x2 Y-Werten.
+ * @param yuyv YUYV 4:2:2 als CV_8UC2 (Y, U bzw. Y, V je Pixel). Darf ein ROI sein.
+ * @param dst Ergebnis CV_8UC1, yuyv.cols/2 x yuyv.rows/2. Wird nur bei geänderter Grösse neu angelegt.
+ */
+void preproc::gray_half_yuyv (const cv::Mat &yuyv, cv::Mat &dst)
+{
+    CV_Assert (yuyv.type() == CV_8UC2 && yuyv.cols >= 2 && yuyv.rows >= 2);
+
+    const int w = yuyv.cols / 2;
+    const int h = yuyv.rows / 2;
+    dst.create (h, w, CV_8UC1);
+
+    for (int y=0; y<h; y++) {
+        const uint8_t *s0 = yuyv.ptr<uint8_t>(2 * y);
+        const uint8_t *s1 = yuyv.ptr<uint8_t>(2 * y + 1);
+        uint8_t *d = dst.ptr<uint8_t>(y);
+        for (int x=0; x<w; x++, s0 += 4, s1 += 4)
+            d[x] = (uint8_t)((s0[0] + s0[2] + s1[0] + s1[2] + 2) >> 2);
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Vorschaubild in Graustufen aus 4x4 Stichproben je Feld (Abstand block/4), bei 1/16 also 1/16 aller Pixel.\n
+ *        Die Stichproben werden nicht gemittelt: eine einzelne geänderte Stichprobe bleibt in @ref thumb_changed() sichtbar.
+ * @param src BGR (CV_8UC3), YUYV (CV_8UC2, nur Y) oder Grau (CV_8UC1). Darf ein ROI sein.
+ * @param block Feldgrösse in Pixeln, Vielfaches von 4
+ * @param dst Ergebnis CV_8UC1, 4 * (src.cols/block) x 4 * (src.rows/block), ein Pixel je Stichprobe.
+ *        Wird nur bei geänderter Grösse neu angelegt.
+ */
+void preproc::thumb (const cv::Mat &src, int block, cv::Mat &dst)
+{
+    CV_Assert ((src.type() == CV_8UC3) || (src.type() == CV_8UC2) || (src.type() == CV_8UC1));
+    CV_Assert ((block >= 4) && (block % 4 == 0));
+
+    const int w = src.cols / block;
+    const int h = src.rows / block;
+    const int step = block / 4;                 // Abstand der Stichproben
+    const int cn = src.channels();
+    dst.create (h * 4, w * 4, CV_8UC1);
+
+    for (int y=0; y<h*4; y++) {
+        const uint8_t *s = src.ptr<uint8_t>(y * step);
+        uint8_t *d = dst.ptr<uint8_t>(y);
+        for (int x=0; x<w*4; x++, s += step * cn) {
+            if (cn == 3)
+                d[x] = (uint8_t)((s[0] * GRAY_B + s[1] * GRAY_G + s[2] * GRAY_R + (1 << 13)) >> 14);
+            else
+                d[x] = s[0];    // Grau bzw. Y
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Vergleich zweier Vorschaubilder aus @ref thumb(): Anzahl Felder (4x4 Stichproben), in denen
+ *        die grösste Abweichung einer Stichprobe > thr ist. Ein dünnes Objekt, das nur eine Stichprobe
+ *        trifft, zählt also voll und wird nicht durch den Mittelwert des Feldes verdünnt.
+ * @return Anzahl geänderter Felder. 0: nichts hat sich bewegt.
+ */
+int preproc::thumb_changed (const cv::Mat &a, const cv::Mat &b, int thr)
+{
+    CV_Assert (a.type() == CV_8UC1 && b.type() == CV_8UC1 && a.size() == b.size());
+
+    int cnt = 0;
+    for (int y=0; y+4<=a.rows; y+=4) {
+        for (int x=0; x+4<=a.cols; x+=4) {
+            int dmax = 0;
+            for (int sy=0; sy<4; sy++) {
+                const uint8_t *pa = a.ptr<uint8_t>(y + sy) + x;
+                const uint8_t *pb = b.ptr<uint8_t>(y + sy) + x;
+                for (int sx=0; sx<4; sx++)
+                    dmax = std::max (dmax, abs ((int)pa[sx] - (int)pb[sx]));
+            }
+            cnt += (dmax > thr);
+        }
+    }
+    return cnt;
+}
+
+//! @} preproc
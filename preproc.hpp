@@ -0,0 +1,39 @@
+/*! ------------------------------------------
+ * @defgroup preproc Preproc: schnelle Vorverarbeitung
+ * @{
+ *
+ * @file    preproc.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Graustufen-Wandlung, ROI und Verkleinerung auf die halbe Grösse in einem Durchlauf.\n
+ * Ersetzt im schnellen Pfad (Option --fastpre) cvtColor() und das 1. pyrDown(). Je zwei Quellzeilen
+ * werden gelesen und eine Zielzeile geschrieben; ein Bild in voller Auflösung entsteht nicht.
+ * Die Gewichte entsprechen cv::COLOR_BGR2GRAY, gemittelt wird über 2x2 Pixel.
+ * Liefert die Kamera YUYV (Option --pixfmt yuyv), wird nur die Helligkeit Y gelesen.\n
+ * @ref preproc::thumb() liefert ein Vorschaubild (z.B. Felder von 16x16 Pixeln) aus 4x4 Stichproben je Feld.
+ * Damit entscheidet der Vorfilter (Option --skip), ob ein Bild überhaupt ausgewertet werden muss.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef PREPROC_HPP
+#define PREPROC_HPP
+
+#include <stdint.h>
+
+#include "opencv2/opencv.hpp"
+
+/*! -------------------------------
+ * @brief Schnelle Vorverarbeitung. Alle Funktionen sind static.
+ */
+class preproc {
+public:
+    static void gray_half (const cv::Mat &bgr, cv::Mat &dst);
+    static void gray_half_yuyv (const cv::Mat &yuyv, cv::Mat &dst);
+    static void thumb (const cv::Mat &src, int block, cv::Mat &dst);
+    static int thumb_changed (const cv::Mat &a, const cv::Mat &b, int thr);
+};
+
+#endif
+
+//! @} preproc
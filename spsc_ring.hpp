@@ -0,0 +1,128 @@
+/*! ------------------------------------------
+ * @defgroup spsc_ring Spsc_Ring: Lock-freier Ringpuffer
+ * @{
+ *
+ * @file    spsc_ring.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-16
+ * @brief   Lock-freier Ringpuffer für genau einen Producer und genau einen Consumer.\n
+ * Die Slots werden beim Anlegen einmal erzeugt und danach nur wiederverwendet.
+ * Producer und Consumer arbeiten direkt im Slot (kein Kopieren durch den Ring).
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ *
+ * @code
+ * // Producer
+ * T *p = ring.write_slot();
+ * if (p != NULL) {
+ *     ... p befüllen ...
+ *     ring.commit();
+ * }
+ * // Consumer
+ * size_t skipped;
+ * T *c = ring.newest_slot(&skipped);
+ * if (c != NULL) {
+ *     ... c auswerten ...
+ *     ring.release();
+ * }
+ * @endcode
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/*! -------------------------------
+ * @brief Single-Producer/Single-Consumer Ringpuffer mit N Slots.
+ * @tparam T Slot-Typ
+ * @tparam N Anzahl Slots. Muss eine 2er-Potenz sein.
+ */
+template <typename T, size_t N>
+class spsc_ring {
+    static_assert ((N >= 2) && ((N & (N-1)) == 0), "spsc_ring: N muss eine 2er-Potenz >= 2 sein");
+
+public:
+    spsc_ring () : head(0), tail(0) {}
+
+    spsc_ring (spsc_ring&) = delete;
+    void operator= (spsc_ring&) = delete;
+
+    /*! ------------------------------------------
+     * @brief Producer: liefert den nächsten freien Slot.
+     * @return NULL, wenn der Ring voll ist.
+     */
+    T *write_slot ()
+    {
+        size_t h = head.load (std::memory_order_relaxed);
+        if (h - tail.load (std::memory_order_acquire) >= N)
+            return NULL;                                    // Ring ist voll
+        return &buf[h & (N-1)];
+    }
+
+    /*! ------------------------------------------
+     * @brief Producer: der mit @ref write_slot() geholte Slot wird für den Consumer freigegeben.
+     */
+    void commit ()
+    {
+        head.store (head.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /*! ------------------------------------------
+     * @brief Consumer: liefert den ältesten belegten Slot.
+     * @return NULL, wenn der Ring leer ist.
+     */
+    T *read_slot ()
+    {
+        size_t t = tail.load (std::memory_order_relaxed);
+        if (t == head.load (std::memory_order_acquire))
+            return NULL;                                    // Ring ist leer
+        return &buf[t & (N-1)];
+    }
+
+    /*! ------------------------------------------
+     * @brief Consumer: liefert den neuesten belegten Slot.\n
+     *        Alle älteren Slots werden übersprungen und sofort an den Producer zurückgegeben.
+     * @param skipped Anzahl der übersprungenen Slots. Darf NULL sein.
+     * @return NULL, wenn der Ring leer ist.
+     */
+    T *newest_slot (size_t *skipped = NULL)
+    {
+        size_t t = tail.load (std::memory_order_relaxed);
+        size_t h = head.load (std::memory_order_acquire);
+        if (t == h)
+            return NULL;                                    // Ring ist leer
+
+        if (skipped != NULL)
+            *skipped = h - t - 1;
+        tail.store (h - 1, std::memory_order_release);     // ältere Slots freigeben
+        return &buf[(h - 1) & (N-1)];
+    }
+
+    /*! ------------------------------------------
+     * @brief Consumer: der mit @ref read_slot() oder @ref newest_slot() geholte Slot wird zurückgegeben.
+     */
+    void release ()
+    {
+        tail.store (tail.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //! Anzahl belegter Slots. Ist nur eine Momentaufnahme.
+    size_t size () const
+    {
+        return head.load (std::memory_order_acquire) - tail.load (std::memory_order_acquire);
+    }
+
+    bool empty () const { return size() == 0; }
+    static constexpr size_t capacity () { return N; }
+
+private:
+    T buf[N];                                   //!< Slots
+    alignas(64) std::atomic<size_t> head;       //!< Schreibindex. Wird nur vom Producer verändert.
+    alignas(64) std::atomic<size_t> tail;       //!< Leseindex. Wird nur vom Consumer verändert.
+};
+
+#endif
+
+//! @} spsc_ring
@@ -0,0 +1,451 @@
+/*! ------------------------------------------
+ * @addtogroup storage
+ * @{
+ *
+ * @file    storage.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref storage.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include "storage.hpp"
+
+using namespace std;
+
+#define MB (1024ll * 1024ll)
+
+/*! ----------------------------------------------
+ * @brief Video-Datei? Entscheidet die Endung.
+ */
+bool storage::is_video (const std::string &name)
+{
+    size_t dot = name.rfind ('.');
+    if (dot == std::string::npos)
+        return false;
+    std::string ext = name.substr (dot + 1);
+    return (ext == "avi") || (ext == "mkv") || (ext == "mp4");
+}
+
+/*! ----------------------------------------------
+ * @brief Gehört die Datei in den Index? Videos und Bilder (.jpg).
+ */
+bool storage::is_managed (const std::string &name)
+{
+    return is_video (name) || ((name.size() > 4) && (name.compare (name.size() - 4, 4, ".jpg") == 0));
+}
+
+/*! ----------------------------------------------
+ * @brief Untertitel zum Video: Endung durch .vtt ersetzt.
+ */
+std::string storage::sidecar_of (const std::string &name)
+{
+    size_t dot = name.rfind ('.');
+    return ((dot == std::string::npos) ? name : name.substr (0, dot)) + ".vtt";
+}
+
+/*! ----------------------------------------------
+ * @brief Pfad relativ zum Video-Verzeichnis.
+ * @return leer, wenn fname nicht unter @ref root liegt
+ */
+std::string storage::relative (const std::string &fname)
+{
+    if ((fname.size() > root.size() + 1) && (fname.compare (0, root.size(), root) == 0) && (fname[root.size()] == '/'))
+        return fname.substr (root.size() + 1);
+    return "";
+}
+
+/*! ----------------------------------------------
+ * @brief Verzeichnis rekursiv einlesen. Versteckte Einträge (z.B. der Index) werden übersprungen.
+ * @param rel Verzeichnis relativ zu @ref root, "" = root
+ */
+void storage::scan (const std::string &rel, int depth, std::vector<struct _st_file_> &out)
+{
+    const std::string dir = (rel.empty()) ? root : root + "/" + rel;
+    DIR *d = opendir (dir.c_str());
+    if (d == NULL)
+        return;
+
+    struct dirent *e;
+    while ((e = readdir (d)) != NULL) {
+        if (e->d_name[0] == '.')
+            continue;
+        const std::string name = e->d_name;
+        const std::string r = (rel.empty()) ? name : rel + "/" + name;
+        struct stat st;
+        if (stat ((root + "/" + r).c_str(), &st) != 0)
+            continue;
+
+        if (S_ISDIR (st.st_mode)) {
+            if (depth < ST_MAX_DEPTH)
+                scan (r, depth + 1, out);
+        } else if (S_ISREG (st.st_mode) && is_managed (name)) {
+            struct _st_file_ f;
+            f.path = r;
+            f.size = st.st_size;
+            f.mtime = st.st_mtime;
+            struct stat vtt;
+            if (is_video (name) && (stat ((root + "/" + sidecar_of (r)).c_str(), &vtt) == 0))
+                f.size += vtt.st_size;
+            out.push_back (f);
+        }
+    }
+    closedir (d);
+}
+
+/*! ----------------------------------------------
+ * @brief Index von der Platte lesen. Zeilenformat: mtime;size;meta;path
+ */
+void storage::load_index (std::vector<struct _st_file_> &out)
+{
+    ifstream in ((root + "/" + ST_INDEX).c_str());
+    std::string line;
+    while (std::getline (in, line)) {
+        size_t p1 = line.find (';');
+        size_t p2 = (p1 == std::string::npos) ? p1 : line.find (';', p1 + 1);
+        size_t p3 = (p2 == std::string::npos) ? p2 : line.find (';', p2 + 1);
+        if (p3 == std::string::npos)
+            continue;
+        struct _st_file_ f;
+        f.mtime = (time_t)atoll (line.c_str());
+        f.size = atoll (line.c_str() + p1 + 1);
+        f.meta = line.substr (p2 + 1, p3 - p2 - 1);
+        f.path = line.substr (p3 + 1);
+        out.push_back (f);
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Index auf die Platte schreiben: erst in eine temporäre Datei, dann rename(). 
+ *        Ein Absturz hinterlässt also immer einen vollständigen Index.
+ */
+void storage::save_index ()
+{
+    std::deque<struct _st_file_> copy;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        copy = files;
+    }
+
+    const std::string fname = root + "/" + ST_INDEX;
+    const std::string tmp = fname + ".tmp";
+    {
+        ofstream out (tmp.c_str(), std::ios::out | std::ios::trunc);
+        for (const struct _st_file_ &f : copy)
+            out << (long long)f.mtime << ';' << f.size << ';' << f.meta << ';' << f.path << '\n';
+        if (!out.good()) {
+            cout << "ERROR storage: cant write " << tmp << endl;
+            return;
+        }
+    }
+    std::rename (tmp.c_str(), fname.c_str());
+}
+
+/*! ----------------------------------------------
+ * @brief Freier Platz im Video-Verzeichnis in [Byte].
+ */
+long long storage::free_bytes ()
+{
+    struct statvfs vfs;
+    if (statvfs (root.c_str(), &vfs) != 0)
+        return -1;
+    return (long long)vfs.f_bavail * (long long)vfs.f_frsize;
+}
+
+/*! ----------------------------------------------
+ * @brief Datei (und ggf. Untertitel) löschen. Der Index wird vom Aufrufer angepasst.
+ */
+void storage::evict (const struct _st_file_ &f)
+{
+    const std::string full = root + "/" + f.path;
+    std::remove (full.c_str());
+    if (is_video (f.path))
+        std::remove (sidecar_of (full).c_str());
+    ++evicted;
+}
+
+/*! ----------------------------------------------
+ * @brief Eintrag aus dem Index nehmen, ohne die Datei zu löschen.
+ * @note <mtx> muss gesperrt sein.
+ */
+void storage::forget (const std::string &path)
+{
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        if (it->path == path) {
+            bytes -= it->size;
+            videos -= is_video (it->path);
+            files.erase (it);
+            return;
+        }
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Älteste Dateien auswählen, bis Quota und Freiplatz eingehalten sind. Sie fallen sofort aus dem Index;
+ *        gelöscht werden sie vom Aufrufer nach dem Entsperren (@ref evict()).\n
+ *        Der Freiplatz wird einmal vorher gemessen und je Datei um ihre Grösse fortgeschrieben.\n
+ *        Die neueste Datei bleibt immer. Reicht auch das ganze übrige Archiv nicht für --minfree
+ *        (andere Daten auf der Karte, laufende Aufnahme), wird für den Freiplatz nichts gelöscht.\n
+ *        --maxvideo bleibt bei @ref save_video und zählt wie bisher nur die Videos dieses Laufs.
+ * @param avail freier Platz vor dem Löschen in [Byte], -1 = unbekannt
+ * @param victims Ergebnis: zu löschende Dateien
+ * @note <mtx> muss gesperrt sein.
+ */
+void storage::enforce (long long avail, std::vector<struct _st_file_> &victims)
+{
+    bool need_free = (minfree > 0) && (avail >= 0) && (avail < minfree) && !files.empty();
+    if (!need_free)
+        minfree_stuck = false;          // Freiplatz wieder erreicht: --minfree gilt wieder
+    else if (minfree_stuck)
+        need_free = false;
+    else if (minfree - avail > bytes - files.back().size) {
+        cout << "WARNING storage: --minfree " << minfree / MB << " MB nicht erreichbar, frei " << avail / MB 
+             << " MB, Archiv " << bytes / MB << " MB. Es wird nichts gelöscht.\n";
+        minfree_stuck = true;
+        need_free = false;
+    }
+
+    while (files.size() > 1) {          // die neueste Datei bleibt immer
+        const bool space = ((quota > 0) && (bytes > quota)) || (need_free && (avail < minfree));
+        if (!space)
+            break;
+
+        const struct _st_file_ &f = files.front();
+        victims.push_back (f);
+        bytes -= f.size;
+        videos -= is_video (f.path);
+        if (avail >= 0)
+            avail += f.size;
+        files.pop_front();
+        dirty = true;
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Thread: neue Dateien eintragen, Grenzen einhalten und den Index schreiben.
+ */
+void storage::worker (storage *st)
+{
+    std::unique_lock<std::mutex> lk(st->mtx);
+    while (1) {
+        st->cv_job.wait (lk, [st]{ return !st->pending.empty() || !st->gone.empty() || st->dirty || st->ende; });
+
+        while (!st->pending.empty()) {
+            struct _st_file_ f = st->pending.front();
+            st->pending.pop_front();
+
+            lk.unlock();
+            struct stat s, vtt;
+            bool ok = (stat ((st->root + "/" + f.path).c_str(), &s) == 0);
+            if (ok) {
+                f.size = s.st_size;
+                f.mtime = s.st_mtime;
+                if (is_video (f.path) && (stat ((st->root + "/" + sidecar_of (f.path)).c_str(), &vtt) == 0))
+                    f.size += vtt.st_size;
+            }
+            lk.lock();
+
+            if (ok) {
+                st->forget (f.path);            // schon im Index (z.B. out_picture.avi): alten Eintrag ersetzen
+                st->files.push_back (f);        // neueste Datei hinten
+                st->bytes += f.size;
+                st->videos += is_video (f.path);
+                st->dirty = true;
+            }
+        }
+
+        while (!st->gone.empty()) {             // von aussen gelöscht, z.B. --maxvideo
+            st->forget (st->gone.front());
+            st->gone.pop_front();
+            st->dirty = true;
+        }
+
+        if (st->dirty) {
+            std::vector<struct _st_file_> victims;
+            lk.unlock();
+            const long long avail = (st->minfree > 0) ? st->free_bytes() : -1;  // statvfs() ohne Sperre
+            lk.lock();
+            st->enforce (avail, victims);
+            st->dirty = false;
+            lk.unlock();
+            for (const struct _st_file_ &f : victims)
+                st->evict (f);                  // unlink() ohne Sperre: add(), next_index() und show() warten nicht
+            if (!victims.empty() && (avail >= 0) && (avail < st->minfree) && (st->free_bytes() <= avail)) {
+                cout << "WARNING storage: Löschen bringt keinen Freiplatz, --minfree " << st->minfree / MB 
+                     << " MB nicht erreichbar. Es wird nicht weiter gelöscht.\n";
+                st->minfree_stuck = true;       // nur im Worker-Thread benutzt
+            }
+            st->save_index ();
+            lk.lock();
+        }
+
+        if (st->ende && st->pending.empty() && st->gone.empty())
+            break;
+    }
+}
+
+/*! ----------------------------------------------
+ * @brief Video-Verzeichnis einlesen und den Thread starten.\n
+ *        Der ganze Baum wird einmal gelesen; die Ereignis-Daten (meta) kommen aus dem alten Index.
+ * @param root Video-Verzeichnis, z.B. ~/lookat_video
+ * @param quota_mb max. Platz aller Dateien in [MB]. 0 = keine Grenze.
+ * @param minfree_mb min. freier Platz in [MB]. 0 = keine Grenze.
+ *        Ohne --quota und --minfree wird beim Start nichts gelöscht.
+ * @return false: root kann nicht gelesen werden.
+ */
+bool storage::open (const std::string &root, long long quota_mb, long long minfree_mb)
+{
+    stop ();
+
+    this->root = root;
+    while ((this->root.size() > 1) && (this->root.back() == '/'))
+        this->root.pop_back();
+    quota = quota_mb * MB;
+    minfree = minfree_mb * MB;
+
+    struct stat st;
+    if ((stat (this->root.c_str(), &st) != 0) || !S_ISDIR (st.st_mode)) {
+        cout << "ERROR storage: " << this->root << " ist kein Verzeichnis\n";
+        return false;
+    }
+
+    std::vector<struct _st_file_> found, old;
+    scan ("", 0, found);
+    load_index (old);
+
+    std::map<std::string, std::string> meta;
+    for (const struct _st_file_ &f : old)
+        meta[f.path] = f.meta;
+    for (struct _st_file_ &f : found) {
+        auto it = meta.find (f.path);
+        if (it != meta.end())
+            f.meta = it->second;
+    }
+    std::sort (found.begin(), found.end(), [](const struct _st_file_ &a, const struct _st_file_ &b) {
+        return (a.mtime != b.mtime) ? (a.mtime < b.mtime) : (a.path < b.path);
+    });
+
+    files.assign (found.begin(), found.end());
+    bytes = 0;
+    videos = 0;
+    for (const struct _st_file_ &f : files) {
+        bytes += f.size;
+        videos += is_video (f.path);
+    }
+    cout << "storage: " << files.size() << " Dateien, " << bytes / MB << " MB in " << this->root << endl;
+
+    ende = false;
+    dirty = true;                   // Grenzen prüfen und Index schreiben macht der Thread
+    th = new std::thread (worker, this);
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Thread beenden. Offene Aufträge werden noch abgearbeitet.
+ */
+void storage::stop ()
+{
+    if (th == NULL)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        ende = true;
+    }
+    cv_job.notify_all();
+    th->join();
+    delete th;
+    th = NULL;
+}
+
+/*! ----------------------------------------------
+ * @brief Neue Datei melden, z.B. von @ref save_video nach dem Schliessen eines Videos.\n
+ *        Eintragen und ggf. Löschen macht der Thread; der Aufrufer wartet nicht auf die Platte.
+ * @param fname voller Pfad. Dateien ausserhalb des Video-Verzeichnisses werden ignoriert.
+ * @param meta Ereignis-Daten, ohne ';' und Zeilenumbruch
+ */
+void storage::add (const std::string &fname, const std::string &meta)
+{
+    struct _st_file_ f;
+    f.path = relative (fname);
+    if ((th == NULL) || f.path.empty())
+        return;
+    f.meta = meta;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        pending.push_back (f);
+    }
+    cv_job.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief Gelöschte Datei melden, z.B. von @ref save_video bei --maxvideo. Der Eintrag fällt aus dem Index.
+ * @param fname voller Pfad
+ */
+void storage::remove (const std::string &fname)
+{
+    const std::string rel = relative (fname);
+    if ((th == NULL) || rel.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        gone.push_back (rel);
+    }
+    cv_job.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief Nächste freie Nr. für out<N>.* im Ordner folder, aus dem Index statt mit stat() je Nr.
+ * @return grösste Nr. + 1, 0 bei leerem Ordner
+ */
+int storage::next_index (const std::string &folder)
+{
+    const std::string rel = relative (folder);
+    const std::string prefix = (rel.empty()) ? "out" : rel + "/out";
+
+    int next = 0;
+    std::lock_guard<std::mutex> lk(mtx);
+    for (const struct _st_file_ &f : files) {
+        if (f.path.compare (0, prefix.size(), prefix) != 0)
+            continue;
+        const char *p = f.path.c_str() + prefix.size();
+        char *end;
+        long n = strtol (p, &end, 10);
+        if ((end != p) && (*end == '.') && (strchr (end, '/') == NULL) && (n + 1 > next))
+            next = n + 1;
+    }
+    return next;
+}
+
+/*! ----------------------------------------------
+ * @brief Belegung und die neuesten Dateien im Terminal anzeigen.
+ */
+void storage::show ()
+{
+    const long long avail = free_bytes();        // statvfs() ohne Sperre
+    std::lock_guard<std::mutex> lk(mtx);
+    cout << "------ storage " << root << " --------\n";
+    cout << "Dateien:   " << files.size() << " (" << videos << " Videos)\n";
+    cout << "belegt:    " << bytes / MB << " MB" << ((quota > 0) ? " von " + std::to_string (quota / MB) + " MB" : "") << endl;
+    cout << "frei:      " << avail / MB << " MB" << ((minfree > 0) ? ", min. " + std::to_string (minfree / MB) + " MB" : "") << endl;
+    cout << "gelöscht:  " << evicted << endl;
+    size_t first = (files.size() > 20) ? files.size() - 20 : 0;
+    for (size_t i=first; i<files.size(); i++)
+        cout << files[i].path << "  " << files[i].size / 1024 << " kB  " << files[i].meta << endl;
+    cout << endl;
+}
+
+//! @} storage
@@ -0,0 +1,98 @@
+/*! ------------------------------------------
+ * @defgroup storage Storage: Speicherplatz der Videos verwalten
+ * @{
+ *
+ * @file    storage.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Index aller Videos und Bilder unter dem Video-Verzeichnis (z.B. ~/lookat_video) mit Quota.\n
+ * Beim Start wird der ganze Baum (Tagesordner, cam<N>) einmal eingelesen und mit dem Index auf der Platte
+ * (@ref ST_INDEX) abgeglichen. Neue Videos meldet @ref save_video mit @ref storage::add(). 
+ * Sind Quota (--quota) oder Mindest-Freiplatz (--minfree) überschritten, werden die ältesten
+ * Dateien über alle Tagesordner gelöscht. Löschen und Schreiben des Index macht ein eigener Thread.
+ * --maxvideo bleibt bei @ref save_video (Videos dieses Laufs); dort gelöschte Dateien meldet @ref storage::remove().
+ * Untertitel (.vtt) gehören zum Video mit gleichem Namen und werden mit ihm gelöscht.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef STORAGE_HPP
+#define STORAGE_HPP
+
+#include <time.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ST_INDEX ".lookat_index"    //!< Index im Video-Verzeichnis. Eine Zeile je Datei: mtime;size;meta;path
+#define ST_QUOTA 0                  //!< Default: max. Platz der Videos in [MB]. 0 = keine Grenze. Option --quota
+#define ST_MINFREE 0                //!< Default: min. freier Platz in [MB]. 0 = keine Grenze. Option --minfree
+#define ST_MAX_DEPTH 3              //!< Verzeichnistiefe beim Einlesen: Tag / cam<N> / Datei
+
+/*! -------------------------------
+ * @brief Eine Datei im Index.
+ */
+struct _st_file_ {
+    std::string path;           //!< relativ zum Video-Verzeichnis, z.B. "17_10_2026/out3.mkv"
+    long long size = 0;         //!< [Byte], bei Videos mit Untertitel
+    time_t mtime = 0;           //!< letzte Änderung. Danach wird sortiert.
+    std::string meta;           //!< Ereignis, z.B. "frames=57,sec=5.7,codec=x264". Ohne ';'.
+};
+
+/*! -------------------------------
+ * @brief Speicherverwaltung mit Index auf der Platte.
+ */
+class storage {
+public:
+    storage () {}
+    ~storage () { stop (); }
+
+    storage (storage&) = delete;
+    void operator= (storage&) = delete;
+
+    bool open (const std::string &root, long long quota_mb, long long minfree_mb);
+    void stop ();
+    void add (const std::string &fname, const std::string &meta);
+    void remove (const std::string &fname);
+    int next_index (const std::string &folder);
+    void show ();
+
+private:
+    void scan (const std::string &rel, int depth, std::vector<struct _st_file_> &out);
+    void load_index (std::vector<struct _st_file_> &out);
+    void save_index ();
+    void enforce (long long avail, std::vector<struct _st_file_> &victims);
+    void evict (const struct _st_file_ &f);
+    void forget (const std::string &path);
+    long long free_bytes ();
+    std::string relative (const std::string &fname);
+    static bool is_video (const std::string &name);
+    static bool is_managed (const std::string &name);
+    static std::string sidecar_of (const std::string &name);
+    static void worker (storage *st);
+
+    std::string root;                       //!< Video-Verzeichnis ohne '/' am Ende
+    long long quota = 0;                    //!< [Byte], 0 = aus
+    long long minfree = 0;                  //!< [Byte], 0 = aus
+    std::deque<struct _st_file_> files;     //!< Index, älteste Datei vorne
+    long long bytes = 0;                    //!< Summe aller Dateien im Index
+    int videos = 0;                         //!< Anzahl Videos im Index
+
+    std::mutex mtx;                         //!< schützt Index und Auftragsliste
+    std::condition_variable cv_job;
+    std::deque<struct _st_file_> pending;   //!< neue Dateien für den Thread
+    std::deque<std::string> gone;           //!< von aussen gelöschte Dateien (relativ) für den Thread
+    bool dirty = false;                     //!< Index muss neu geschrieben werden
+    bool ende = false;
+    std::thread *th = NULL;
+    std::atomic<int> evicted {0};           //!< gelöschte Dateien seit dem Start
+    bool minfree_stuck = false;             //!< --minfree nicht erreichbar: bis genug frei ist, wird dafür nichts gelöscht
+};
+
+#endif
+
+//! @} storage
@@ -0,0 +1,149 @@
+/*! ------------------------------------------
+ * @addtogroup sv_encoder
+ * @{
+ *
+ * @file    sv_encoder.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref sv_encoder.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <sys/stat.h>
+
+#include "sv_encoder.hpp"
+
+using namespace std;
+
+/*! ----------------------------------------------
+ * @brief Name des Encoders für Ausgaben und Optionen.
+ */
+const char *sv_encoder::name (int backend)
+{
+    switch (backend) {
+        case SV_ENC_V4L2M2M: return "v4l2m2m";
+        case SV_ENC_X264:    return "x264";
+        case SV_ENC_FFMPEG:  return "ffmpeg";
+        case SV_ENC_MJPG:    return "mjpg";
+    }
+    return "auto";
+}
+
+/*! ----------------------------------------------
+ * @brief Dateiendung des Containers ohne Punkt.
+ */
+const char *sv_encoder::ext (int container)
+{
+    switch (container) {
+        case SV_CONT_MKV: return "mkv";
+        case SV_CONT_MP4: return "mp4";
+        case SV_CONT_AVI: return "avi";
+    }
+    return "avi";
+}
+
+/*! ----------------------------------------------
+ * @brief GStreamer-Pipeline für v4l2m2m bzw. x264. appsrc wird von cv::VideoWriter gespeist.
+ */
+std::string sv_encoder::pipeline (const struct _sv_codec_ &c, const std::string &fname)
+{
+    char enc[256];
+    if (c.backend == SV_ENC_V4L2M2M)    // Bitrate in bit/s, level 4 wird vom Pi-Encoder verlangt
+        sprintf (enc, "video/x-raw,format=I420 ! v4l2h264enc extra-controls=\"controls,video_bitrate=%i,h264_i_frame_period=%i\" ! "
+                      "video/x-h264,level=(string)4", c.bitrate * 1000, c.gop);
+    else
+        sprintf (enc, "x264enc speed-preset=ultrafast tune=zerolatency bitrate=%i key-int-max=%i", c.bitrate, c.gop);
+
+    const char *mux = (c.container == SV_CONT_MP4) ? "mp4mux" : (c.container == SV_CONT_AVI) ? "avimux" : "matroskamux";
+
+    return std::string ("appsrc ! videoconvert ! ") + enc + " ! h264parse ! " + mux + " ! filesink location=\"" + fname + "\"";
+}
+
+/*! ----------------------------------------------
+ * @brief cv::VideoWriter für den Encoder aus c anlegen.
+ * @param c Einstellungen nach @ref probe(). backend und container dürfen nicht AUTO sein.
+ * @return VideoWriter. Ob er geöffnet ist, prüft der Aufrufer mit isOpened().
+ */
+cv::VideoWriter *sv_encoder::create (const struct _sv_codec_ &c, const std::string &fname, double fps, cv::Size size, bool color)
+{
+    switch (c.backend) {
+        case SV_ENC_V4L2M2M:
+        case SV_ENC_X264:
+            return new cv::VideoWriter (pipeline (c, fname), cv::CAP_GSTREAMER, 0, fps, size, color);
+        case SV_ENC_FFMPEG:
+            return new cv::VideoWriter (fname, cv::CAP_FFMPEG, cv::VideoWriter::fourcc('a','v','c','1'), fps, size, color);
+    }
+    // MJPG macht keine Graustufen-Videos
+    return new cv::VideoWriter (fname, cv::VideoWriter::fourcc('M','J','P','G'), fps, size, color);
+}
+
+/*! ----------------------------------------------
+ * @brief Einen Encoder mit einer Probedatei testen.
+ * @return true: die Probedatei ist nicht leer
+ */
+bool sv_encoder::try_backend (struct _sv_codec_ &c, const std::string &folder)
+{
+    if (c.backend == SV_ENC_MJPG)
+        c.container = SV_CONT_AVI;
+    const std::string fname = folder + "/.probe." + ext (c.container);
+
+    cv::VideoWriter *vw = create (c, fname, 10.0, cv::Size (320, 240), true);
+    bool ok = vw->isOpened ();
+    if (ok) {
+        cv::Mat img (240, 320, CV_8UC3);
+        for (int i=0; i<SV_PROBE_FRAMES; i++) {
+            img.setTo (cv::Scalar (i * 20, 128, 255 - i * 20));
+            vw->write (img);
+        }
+    }
+    vw->release ();
+    delete vw;
+
+    struct stat st;
+    ok = ok && (stat (fname.c_str(), &st) == 0) && (st.st_size > 0);
+    std::remove (fname.c_str());
+    return ok;
+}
+
+/*! ----------------------------------------------
+ * @brief Encoder beim Start ermitteln.\n
+ *        SV_ENC_AUTO: v4l2m2m, x264, ffmpeg, mjpg in dieser Reihenfolge.
+ *        Ein vorgegebener Encoder, der nicht funktioniert, fällt auf mjpg zurück.
+ * @param c Einstellungen. backend und container werden auf den gewählten Encoder gesetzt.
+ * @param folder Verzeichnis für die Probedatei, z.B. @ref MotionDetector::folder
+ * @return gewählter Encoder SV_ENC_xxx
+ */
+int sv_encoder::probe (struct _sv_codec_ &c, const std::string &folder)
+{
+    const int wish = c.backend;
+    const int wish_cont = c.container;
+    const int order[] = { SV_ENC_V4L2M2M, SV_ENC_X264, SV_ENC_FFMPEG };
+
+    for (int b : order) {
+        if ((wish != SV_ENC_AUTO) && (wish != b))
+            continue;
+        c.backend = b;
+        c.container = (wish_cont == SV_CONT_AUTO) ? SV_CONT_MKV : wish_cont;
+        if (try_backend (c, folder)) {
+            cout << "Video-Encoder: " << name (c.backend) << ", " << ext (c.container);
+            if (c.backend == SV_ENC_FFMPEG)     // avc1 über cv::VideoWriter: Bitrate und GOP wählt FFmpeg
+                cout << ", --bitrate/--gop nicht wirksam\n";
+            else
+                cout << ", " << c.bitrate << " kbit/s, GOP " << c.gop << endl;
+            return c.backend;
+        }
+        cout << "Video-Encoder: " << name (b) << " nicht verfügbar\n";
+    }
+
+    c.backend = SV_ENC_MJPG;
+    c.container = SV_CONT_AVI;
+    if (!try_backend (c, folder))
+        cout << "ERROR Video-Encoder: auch mjpg schreibt keine Datei in " << folder << endl;
+    cout << "Video-Encoder: mjpg, avi\n";
+    return c.backend;
+}
+
+//! @} sv_encoder
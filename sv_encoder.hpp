@@ -0,0 +1,72 @@
+/*! ------------------------------------------
+ * @defgroup sv_encoder Sv_Encoder: Video-Encoder für save_video
+ * @{
+ *
+ * @file    sv_encoder.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Auswahl des Video-Encoders für @ref save_video.\n
+ * H.264 braucht etwa 1/10 des Speicherplatzes von MJPG. Ob ein H.264-Encoder vorhanden ist, hängt vom System ab
+ * (OpenCV mit GStreamer bzw. FFmpeg, Raspberry Pi mit Hardware-Encoder). @ref sv_encoder::probe() versucht
+ * beim Start der Reihe nach:
+ * - v4l2m2m: GStreamer v4l2h264enc, Hardware-Encoder des Raspberry Pi (V4L2 Memory-to-Memory)
+ * - x264:    GStreamer x264enc, Software mit speed-preset=ultrafast
+ * - ffmpeg:  cv::VideoWriter mit FFmpeg, fourcc avc1
+ * - mjpg:    MJPG im AVI. Geht immer, wie bisher.
+ *
+ * Für jeden Kandidaten werden einige Bilder in eine Probedatei geschrieben. Der erste, der eine
+ * nicht leere Datei erzeugt, wird verwendet. Bitrate und GOP wirken nur bei v4l2m2m und x264.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef SV_ENCODER_HPP
+#define SV_ENCODER_HPP
+
+#include <string>
+
+#include "opencv2/opencv.hpp"
+
+#define SV_ENC_AUTO 0           //!< Encoder beim Start ermitteln. Option --codec auto
+#define SV_ENC_V4L2M2M 1        //!< GStreamer v4l2h264enc (Hardware). Option --codec v4l2m2m
+#define SV_ENC_X264 2           //!< GStreamer x264enc ultrafast. Option --codec x264
+#define SV_ENC_FFMPEG 3         //!< FFmpeg, fourcc avc1. Option --codec ffmpeg
+#define SV_ENC_MJPG 4           //!< MJPG im AVI. Option --codec mjpg
+
+#define SV_CONT_AUTO 0          //!< H.264: mkv, MJPG: avi. Option --container auto
+#define SV_CONT_MKV 1           //!< Matroska. Bleibt bei Stromausfall bis zum letzten Cluster lesbar.
+#define SV_CONT_MP4 2           //!< MP4. Erst nach close() vollständig.
+#define SV_CONT_AVI 3           //!< AVI
+
+#define SV_BITRATE 2000         //!< Default: H.264-Bitrate in [kbit/s]. Option --bitrate
+#define SV_GOP 50               //!< Default: Abstand der Keyframes in Bildern. Option --gop
+#define SV_PROBE_FRAMES 10      //!< Bilder je Probedatei. Einige Encoder schreiben erst nach mehreren Bildern.
+
+/*! -------------------------------
+ * @brief Encoder-Einstellungen.
+ */
+struct _sv_codec_ {
+    int backend = SV_ENC_AUTO;      //!< SV_ENC_xxx. Nach @ref sv_encoder::probe() nie SV_ENC_AUTO.
+    int container = SV_CONT_AUTO;   //!< SV_CONT_xxx. Nach @ref sv_encoder::probe() nie SV_CONT_AUTO.
+    int bitrate = SV_BITRATE;       //!< [kbit/s]
+    int gop = SV_GOP;               //!< Bilder
+};
+
+/*! -------------------------------
+ * @brief Encoder ermitteln und cv::VideoWriter anlegen. Alle Funktionen sind static.
+ */
+class sv_encoder {
+public:
+    static int probe (struct _sv_codec_ &c, const std::string &folder);
+    static cv::VideoWriter *create (const struct _sv_codec_ &c, const std::string &fname, double fps, cv::Size size, bool color);
+    static const char *name (int backend);
+    static const char *ext (int container);
+
+private:
+    static std::string pipeline (const struct _sv_codec_ &c, const std::string &fname);
+    static bool try_backend (struct _sv_codec_ &c, const std::string &folder);
+};
+
+#endif
+
+//! @} sv_encoder
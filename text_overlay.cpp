@@ -0,0 +1,109 @@
+/*! ------------------------------------------
+ * @addtogroup text_overlay
+ * @{
+ *
+ * @file    text_overlay.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref text_overlay.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <cstdio>
+
+#include "text_overlay.hpp"
+
+/*! ----------------------------------------------
+ * @brief Atlas rendern. Der Vorschub eines Zeichens ist die Breite aus cv::getTextSize() ohne die Strichstärke,
+ *        so wie cv::putText() die Zeichen aneinanderreiht.
+ */
+void text_overlay::init ()
+{
+    int baseline = 0;
+    cv::Size sz = cv::getTextSize ("0123456789Agjpy|", TO_FONT, TO_SCALE, TO_THICK, &baseline);
+    ascent = sz.height + TO_THICK;
+    height = ascent + baseline + 2 * TO_THICK;
+
+    for (int c=TO_FIRST; c<=TO_LAST; c++) {
+        char s[2] = { (char)c, 0 };
+        struct _glyph_ &g = atlas[c - TO_FIRST];
+        sz = cv::getTextSize (s, TO_FONT, TO_SCALE, TO_THICK, &baseline);
+        g.adv = sz.width - TO_THICK;
+        g.mask = cv::Mat::zeros (height, sz.width + 2 * TO_THICK, CV_8UC1);
+        cv::putText (g.mask, s, cv::Point (TO_THICK, ascent), TO_FONT, TO_SCALE, cv::Scalar (255), TO_THICK);
+    }
+    ready = true;
+}
+
+/*! ----------------------------------------------
+ * @brief Maske an (x, y) in dst einfärben. Wird am Bildrand abgeschnitten.
+ */
+void text_overlay::blit (cv::Mat &dst, int x, int y, const cv::Mat &mask, cv::Scalar color)
+{
+    cv::Rect r = cv::Rect (x, y, mask.cols, mask.rows) & cv::Rect (0, 0, dst.cols, dst.rows);
+    if (r.empty())
+        return;
+    cv::Mat roi = dst(r);
+    roi.setTo (color, mask(cv::Rect (r.x - x, r.y - y, r.width, r.height)));
+}
+
+/*! ----------------------------------------------
+ * @brief Zeichenkette aus dem Atlas. Zeichen ausserhalb von ASCII 32..126 werden als ' ' gesetzt.
+ * @param x Stiftposition
+ * @param top Oberkante der Masken
+ * @return neue Stiftposition
+ */
+double text_overlay::put (cv::Mat &dst, double x, int top, const char *s, cv::Scalar color)
+{
+    for (; *s; s++) {
+        int c = (unsigned char)*s;
+        if ((c < TO_FIRST) || (c > TO_LAST))
+            c = ' ';
+        const struct _glyph_ &g = atlas[c - TO_FIRST];
+        if (c != ' ')
+            blit (dst, cvRound (x) - TO_THICK, top, g.mask, color);
+        x += g.adv;
+    }
+    return x;
+}
+
+/*! ----------------------------------------------
+ * @brief Textzeile "counter / TT.MM.JJJJ | hh:mm:ss | str" zeichnen, Layout wie cv::putText().
+ * @param dst Bild CV_8UC3 oder CV_8UC1
+ * @param org linke Grundlinie wie bei cv::putText()
+ * @param counter Bildzähler. Ziffern aus dem Atlas.
+ * @param t Zeitstempel. Datum und Uhrzeit werden einmal pro Sekunde als Streifen gerendert.
+ * @param str Zusatztext oder NULL. Zeichen aus dem Atlas.
+ */
+void text_overlay::draw (cv::Mat &dst, cv::Point org, int counter, time_t t, const char *str, cv::Scalar color)
+{
+    if (!ready)
+        init ();
+
+    if (t != strip_sec) {   // neue Sekunde: Streifen "Datum | Uhrzeit | " neu rendern
+        struct tm tm;
+        localtime_r (&t, &tm);
+        char buf[64];
+        sprintf (buf, "%02i.%02i.%i | %02i:%02i:%02i | ", tm.tm_mday, tm.tm_mon+1, tm.tm_year+1900,
+                                                            tm.tm_hour, tm.tm_min, tm.tm_sec);
+        int baseline = 0;
+        cv::Size sz = cv::getTextSize (buf, TO_FONT, TO_SCALE, TO_THICK, &baseline);
+        strip_adv = sz.width - TO_THICK;
+        strip.create (height, sz.width + 2 * TO_THICK, CV_8UC1);
+        strip = cv::Scalar (0);
+        cv::putText (strip, buf, cv::Point (TO_THICK, ascent), TO_FONT, TO_SCALE, cv::Scalar (255), TO_THICK);
+        strip_sec = t;
+    }
+
+    const int top = org.y - ascent;
+    char num[16];
+    sprintf (num, "%i / ", counter);
+    double x = put (dst, org.x, top, num, color);
+    blit (dst, cvRound (x) - TO_THICK, top, strip, color);
+    x += strip_adv;
+    if (str != NULL)
+        put (dst, x, top, str, color);
+}
+
+//! @} text_overlay
@@ -0,0 +1,62 @@
+/*! ------------------------------------------
+ * @defgroup text_overlay Text_Overlay: vorgerenderter Text im Bild
+ * @{
+ *
+ * @file    text_overlay.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Ersetzt cv::putText() für die Textzeile im Video (@ref save_video::write_date_to_pic()).\n
+ * Jedes Zeichen wird einmal als Maske gerendert (Atlas, ASCII 32..126). Der Teil mit Datum und Uhrzeit
+ * ändert sich nur einmal pro Sekunde und wird dann als ganzer Streifen neu gerendert. Je Bild werden nur
+ * noch Masken mit setTo(Farbe, Maske) ins Bild kopiert: einige kB statt Vektor-Rasterung der ganzen Zeile.
+ * Schrift wie bisher: FONT_HERSHEY_PLAIN, Grösse 1.0, Strichstärke 2.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef TEXT_OVERLAY_HPP
+#define TEXT_OVERLAY_HPP
+
+#include <time.h>
+#include <string>
+
+#include "opencv2/opencv.hpp"
+
+#define TO_FONT cv::FONT_HERSHEY_PLAIN      //!< Schriftart
+#define TO_SCALE 1.0                        //!< Schriftgrösse
+#define TO_THICK 2                          //!< Strichstärke
+#define TO_FIRST 32                         //!< erstes Zeichen im Atlas (' ')
+#define TO_LAST 126                         //!< letztes Zeichen im Atlas ('~')
+
+/*! -------------------------------
+ * @brief Ein Zeichen im Atlas.
+ */
+struct _glyph_ {
+    cv::Mat mask;               //!< CV_8UC1, 255 = Schrift. Links um TO_THICK Pixel erweitert.
+    double adv = 0;             //!< Vorschub in Pixeln wie bei cv::putText()
+};
+
+/*! -------------------------------
+ * @brief Textzeile "Zähler / Datum | Uhrzeit | Zusatztext" mit Cache.
+ */
+class text_overlay {
+public:
+    void draw (cv::Mat &dst, cv::Point org, int counter, time_t t, const char *str, cv::Scalar color);
+
+private:
+    void init ();
+    double put (cv::Mat &dst, double x, int top, const char *s, cv::Scalar color);
+    static void blit (cv::Mat &dst, int x, int y, const cv::Mat &mask, cv::Scalar color);
+
+    struct _glyph_ atlas[TO_LAST - TO_FIRST + 1];   //!< Masken der Zeichen
+    bool ready = false;         //!< Atlas ist gerendert
+    int ascent = 0;             //!< Höhe über der Grundlinie
+    int height = 0;             //!< Höhe aller Masken
+    time_t strip_sec = -1;      //!< Sekunde, für die @ref strip gilt
+    cv::Mat strip;              //!< Maske "Datum | Uhrzeit | "
+    double strip_adv = 0;       //!< Vorschub von @ref strip
+};
+
+#endif
+
+//! @} text_overlay
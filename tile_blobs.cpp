@@ -0,0 +1,98 @@
+/*! ------------------------------------------
+ * @addtogroup tile_blobs
+ * @{
+ *
+ * @file    tile_blobs.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref tile_blobs.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+
+#include "tile_blobs.hpp"
+
+/*! ----------------------------------------------
+ * @brief Zusammenhängende Felder != 0 in grid suchen (8er-Nachbarschaft, wie cv::findContours()).
+ * @param grid Mosaik-Matrix CV_8UC1. Ein Feld != 0 ist aktiv.
+ * @param cell Grösse eines Feldes in Pixeln. Darf gebrochen sein, wenn die Teilung nicht aufgeht.
+ * @param offset Pixel-Position von Feld (0, 0)
+ * @param blobs Ergebnis. Wird vorher gelöscht. Die Kapazität bleibt erhalten.
+ * @return Anzahl Blobs
+ */
+int tile_blobs::label (const cv::Mat &grid, cv::Size2f cell, cv::Point offset, std::vector<struct _blob_> &blobs)
+{
+    CV_Assert (grid.type() == CV_8UC1);
+
+    const int rows = grid.rows;
+    const int cols = grid.cols;
+
+    static thread_local std::vector<uint8_t> seen;     // schon einem Blob zugeordnet
+    static thread_local std::vector<int> stack;        // offene Felder, Index = y * cols + x
+    seen.assign (rows * cols, 0);
+    blobs.clear ();
+
+    for (int y0=0; y0<rows; y0++) {
+        for (int x0=0; x0<cols; x0++) {
+            if ((grid.at<uint8_t>(y0, x0) == 0) || seen[y0 * cols + x0])
+                continue;
+
+            // ------------ neuer Blob: Flood-Fill -------------
+            int left = x0, right = x0, top = y0, bottom = y0;
+            int area = 0;
+            long sx = 0, sy = 0;
+
+            stack.clear ();
+            stack.push_back (y0 * cols + x0);
+            seen[y0 * cols + x0] = 1;
+            while (!stack.empty()) {
+                int idx = stack.back();
+                stack.pop_back ();
+                int x = idx % cols;
+                int y = idx / cols;
+
+                ++area;
+                sx += x;
+                sy += y;
+                left = std::min (left, x);
+                right = std::max (right, x);
+                top = std::min (top, y);
+                bottom = std::max (bottom, y);
+
+                for (int dy=-1; dy<=1; dy++) {
+                    int ny = y + dy;
+                    if ((ny < 0) || (ny >= rows))
+                        continue;
+                    for (int dx=-1; dx<=1; dx++) {
+                        int nx = x + dx;
+                        if ((nx < 0) || (nx >= cols))
+                            continue;
+                        int n = ny * cols + nx;
+                        if (!seen[n] && (grid.at<uint8_t>(ny, nx) != 0)) {
+                            seen[n] = 1;
+                            stack.push_back (n);
+                        }
+                    }
+                }
+            }
+
+            struct _blob_ b;
+            b.tiles = cv::Rect (left, top, right - left + 1, bottom - top + 1);
+            b.area = area;
+            b.center = cv::Point2f ((float)sx / area + 0.5f, (float)sy / area + 0.5f);
+            int px = offset.x + cvRound (left * cell.width);
+            int py = offset.y + cvRound (top * cell.height);
+            b.pix = cv::Rect (px, py,
+                              offset.x + cvRound ((right + 1) * cell.width) - px,
+                              offset.y + cvRound ((bottom + 1) * cell.height) - py);
+            b.pix_center = cv::Point2f (offset.x + b.center.x * cell.width, offset.y + b.center.y * cell.height);
+            blobs.push_back (b);
+        }
+    }
+
+    return (int)blobs.size();
+}
+
+//! @} tile_blobs
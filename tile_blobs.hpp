@@ -0,0 +1,43 @@
+/*! ------------------------------------------
+ * @defgroup tile_blobs Tile_Blobs: Bewegungsflächen im Mosaik
+ * @{
+ *
+ * @file    tile_blobs.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Zusammenhängende Mosaik-Felder (8er-Nachbarschaft) werden zu Blobs zusammengefasst.\n
+ * Gearbeitet wird direkt auf dem Mosaik (z.B. 8 x 6 Felder), nicht auf einem vergrösserten Bild.
+ * Für jeden Blob werden Rechteck, Fläche und Schwerpunkt in Feld- und in Pixel-Koordinaten geliefert.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef TILE_BLOBS_HPP
+#define TILE_BLOBS_HPP
+
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+/*! -------------------------------
+ * @brief Ein Blob aus zusammenhängenden Mosaik-Feldern.
+ */
+struct _blob_ {
+    cv::Rect tiles;             //!< umschliessendes Rechteck in Feldern
+    int area;                   //!< Anzahl Felder
+    cv::Point2f center;         //!< Schwerpunkt in Feldern. Feldmitte = x + 0.5
+    cv::Rect pix;               //!< umschliessendes Rechteck in Pixeln
+    cv::Point2f pix_center;     //!< Schwerpunkt in Pixeln
+};
+
+/*! -------------------------------
+ * @brief Connected-Component-Labelling auf dem Mosaik. Alle Funktionen sind static.
+ */
+class tile_blobs {
+public:
+    static int label (const cv::Mat &grid, cv::Size2f cell, cv::Point offset, std::vector<struct _blob_> &blobs);
+};
+
+#endif
+
+//! @} tile_blobs
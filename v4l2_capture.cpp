@@ -0,0 +1,249 @@
+/*! ------------------------------------------
+ * @addtogroup v4l2_capture
+ * @{
+ *
+ * @file    v4l2_capture.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref v4l2_capture.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+#include "v4l2_capture.hpp"
+#include "Frame_Grabber.hpp"    // PIXFMT_YUYV, PIXFMT_MJPG
+
+/*! ----------------------------------------------
+ * @brief ioctl(), wird bei EINTR wiederholt.
+ */
+int v4l2_capture::xioctl (unsigned long request, void *arg)
+{
+    int r;
+    do {
+        r = ioctl (fd, request, arg);
+    } while ((r == -1) && (errno == EINTR));
+    return r;
+}
+
+/*! ----------------------------------------------
+ * @brief Kamera öffnen, Format einstellen, Puffer anlegen und den Stream starten.
+ * @param cam_index Kamera-Nr. Geöffnet wird /dev/video<cam_index>
+ * @param width, height gewünschte Bildgrösse. Der Treiber kann sie anpassen, siehe @ref get_width().
+ * @param pixfmt PIXFMT_YUYV oder PIXFMT_MJPG
+ * @param nbufs Anzahl Treiberpuffer
+ * @return true: Stream läuft.
+ */
+bool v4l2_capture::open (int cam_index, int width, int height, int pixfmt, int nbufs)
+{
+    close ();
+
+    dev = "/dev/video" + std::to_string (cam_index);
+    fd = ::open (dev.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        std::cout << "ERROR v4l2: cant open " << dev << ": " << strerror (errno) << std::endl;
+        return false;
+    }
+
+    // ------------- Fähigkeiten prüfen ---------------
+    struct v4l2_capability cap;
+    memset (&cap, 0, sizeof(cap));
+    if (xioctl (VIDIOC_QUERYCAP, &cap) == -1) {
+        std::cout << "ERROR v4l2: " << dev << " ist kein V4L2-Gerät\n";
+        close ();
+        return false;
+    }
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        std::cout << "ERROR v4l2: " << dev << " kann kein Streaming\n";
+        close ();
+        return false;
+    }
+
+    // ------------- Format -------------------
+    const uint32_t fourcc = (pixfmt == PIXFMT_MJPG) ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
+    struct v4l2_format fmt;
+    memset (&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = fourcc;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    if ((xioctl (VIDIOC_S_FMT, &fmt) == -1) || (fmt.fmt.pix.pixelformat != fourcc)) {
+        std::cout << "ERROR v4l2: " << dev << " unterstützt " << ((pixfmt == PIXFMT_MJPG) ? "MJPEG" : "YUYV") << " nicht\n";
+        close ();
+        return false;
+    }
+    this->width = fmt.fmt.pix.width;
+    this->height = fmt.fmt.pix.height;
+    this->stride = fmt.fmt.pix.bytesperline;
+    if (this->stride < this->width * 2)
+        this->stride = this->width * 2;
+    this->pixfmt = pixfmt;
+
+    struct v4l2_streamparm parm;
+    memset (&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if ((xioctl (VIDIOC_G_PARM, &parm) == 0) && (parm.parm.capture.timeperframe.numerator > 0))
+        fps = (double)parm.parm.capture.timeperframe.denominator / parm.parm.capture.timeperframe.numerator;
+
+    // ------------- Puffer anlegen und einblenden -------------------
+    struct v4l2_requestbuffers req;
+    memset (&req, 0, sizeof(req));
+    req.count = nbufs;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if ((xioctl (VIDIOC_REQBUFS, &req) == -1) || (req.count < 2)) {
+        std::cout << "ERROR v4l2: " << dev << " VIDIOC_REQBUFS\n";
+        close ();
+        return false;
+    }
+
+    for (uint32_t i=0; i<req.count; i++) {
+        struct v4l2_buffer buf;
+        memset (&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl (VIDIOC_QUERYBUF, &buf) == -1) {
+            std::cout << "ERROR v4l2: " << dev << " VIDIOC_QUERYBUF\n";
+            close ();
+            return false;
+        }
+        struct _v4l2_buf_ b;
+        b.length = buf.length;
+        b.start = mmap (NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buf.m.offset);
+        if (b.start == MAP_FAILED) {
+            std::cout << "ERROR v4l2: " << dev << " mmap: " << strerror (errno) << std::endl;
+            close ();
+            return false;
+        }
+        bufs.push_back (b);
+    }
+
+    // ------------- alle Puffer einreihen, Stream starten -------------------
+    for (size_t i=0; i<bufs.size(); i++) {
+        if (!requeue ((int)i)) {
+            close ();
+            return false;
+        }
+    }
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl (VIDIOC_STREAMON, &type) == -1) {
+        std::cout << "ERROR v4l2: " << dev << " VIDIOC_STREAMON\n";
+        close ();
+        return false;
+    }
+    streaming = true;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Stream anhalten, Puffer ausblenden und Gerät schliessen.\n
+ *        Alle von @ref dequeue() gelieferten cv::Mat werden danach ungültig.
+ */
+void v4l2_capture::close ()
+{
+    if (fd < 0)
+        return;
+
+    if (streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl (VIDIOC_STREAMOFF, &type);
+        streaming = false;
+    }
+    for (size_t i=0; i<bufs.size(); i++)
+        munmap (bufs[i].start, bufs[i].length);
+    bufs.clear ();
+
+    struct v4l2_requestbuffers req;         // Puffer im Treiber freigeben
+    memset (&req, 0, sizeof(req));
+    req.count = 0;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    xioctl (VIDIOC_REQBUFS, &req);
+
+    ::close (fd);
+    fd = -1;
+}
+
+/*! ----------------------------------------------
+ * @brief Nächstes Bild holen. Wartet max. V4L2_TIMEOUT ms.
+ * @param img Header auf den Treiberpuffer, keine Kopie. YUYV: height x width CV_8UC2, MJPEG: 1 x n CV_8UC1.
+ * @param tv Aufnahme-Zeitpunkt vom Kernel, umgerechnet auf die Uhrzeit (gettimeofday()).
+ * @param index Nr. des Treiberpuffers. Muss mit @ref requeue() zurückgegeben werden.
+ * @return false: Timeout oder Fehler. Es wurde kein Puffer entnommen.
+ */
+bool v4l2_capture::dequeue (cv::Mat &img, struct timeval *tv, int *index)
+{
+    if (!streaming)
+        return false;
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll (&pfd, 1, V4L2_TIMEOUT) <= 0)
+        return false;
+
+    struct v4l2_buffer buf;
+    memset (&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl (VIDIOC_DQBUF, &buf) == -1)
+        return false;
+
+    if ((buf.flags & V4L2_BUF_FLAG_ERROR) || (buf.bytesused == 0)) {     // defektes Bild
+        requeue (buf.index);
+        return false;
+    }
+
+    // ------------ Zeitstempel: Kernel (CLOCK_MONOTONIC) => Uhrzeit -------------
+    struct timeval now;
+    gettimeofday (&now, NULL);
+    if (((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) &&
+        ((buf.timestamp.tv_sec != 0) || (buf.timestamp.tv_usec != 0))) {
+        struct timespec mono;
+        clock_gettime (CLOCK_MONOTONIC, &mono);
+        long long age = ((long long)mono.tv_sec * 1000000ll + mono.tv_nsec / 1000) -
+                        ((long long)buf.timestamp.tv_sec * 1000000ll + buf.timestamp.tv_usec);   // Alter des Bildes in [us]
+        long long us = (long long)now.tv_sec * 1000000ll + now.tv_usec - age;
+        tv->tv_sec = us / 1000000ll;
+        tv->tv_usec = us % 1000000ll;
+    } else
+        *tv = now;
+
+    const struct _v4l2_buf_ &b = bufs[buf.index];
+    if (pixfmt == PIXFMT_MJPG)
+        img = cv::Mat (1, buf.bytesused, CV_8UC1, b.start);
+    else
+        img = cv::Mat (height, width, CV_8UC2, b.start, stride);
+    *index = buf.index;
+    return true;
+}
+
+/*! ----------------------------------------------
+ * @brief Treiberpuffer an den Treiber zurückgeben.
+ */
+bool v4l2_capture::requeue (int index)
+{
+    struct v4l2_buffer buf;
+    memset (&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    if (xioctl (VIDIOC_QBUF, &buf) == -1) {
+        std::cout << "ERROR v4l2: " << dev << " VIDIOC_QBUF " << index << ": " << strerror (errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//! @} v4l2_capture
@@ -0,0 +1,78 @@
+/*! ------------------------------------------
+ * @defgroup v4l2_capture V4l2_Capture: Bildeinzug direkt über V4L2
+ * @{
+ *
+ * @file    v4l2_capture.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Class für den Bildeinzug ohne cv::VideoCapture.\n
+ * Die Treiberpuffer werden mit VIDIOC_REQBUFS (MMAP) angelegt und in den Speicher eingeblendet.
+ * @ref v4l2_capture::dequeue() liefert ein cv::Mat, das direkt auf den Treiberpuffer zeigt (keine Kopie),
+ * und den Zeitstempel des Kernels. Der Puffer gehört dem Aufrufer, bis er mit @ref v4l2_capture::requeue()
+ * zurückgegeben wird.\n
+ * Unterstützt werden YUYV und MJPEG. Testen ohne Kamera: sudo modprobe vivid
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef V4L2_CAPTURE_HPP
+#define V4L2_CAPTURE_HPP
+
+#include <stdint.h>
+#include <sys/time.h>
+#include <string>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+#define V4L2_BUFS 8             //!< Default für die Anzahl Treiberpuffer. Option --v4l2bufs
+#define V4L2_TIMEOUT 1000       //!< Max. Wartezeit in [ms] in @ref v4l2_capture::dequeue()
+
+/*! -------------------------------
+ * @brief Ein eingeblendeter Treiberpuffer.
+ */
+struct _v4l2_buf_ {
+    void *start;                //!< Adresse nach mmap()
+    size_t length;              //!< Länge in Bytes
+};
+
+/*! -------------------------------
+ * @brief class für den Bildeinzug über V4L2 mit MMAP-Puffern.
+ */
+class v4l2_capture {
+public:
+    v4l2_capture () {}
+    ~v4l2_capture () { close (); }
+
+    v4l2_capture (v4l2_capture&) = delete;
+    void operator= (v4l2_capture&) = delete;
+
+    bool open (int cam_index, int width, int height, int pixfmt, int nbufs = V4L2_BUFS);
+    void close ();
+    bool is_open () { return fd >= 0; }
+
+    bool dequeue (cv::Mat &img, struct timeval *tv, int *index);
+    bool requeue (int index);
+
+    int get_width () { return width; }
+    int get_height () { return height; }
+    int get_pixfmt () { return pixfmt; }
+    int get_nbufs () { return (int)bufs.size(); }
+    double get_fps () { return fps; }
+
+private:
+    int xioctl (unsigned long request, void *arg);
+
+    int fd = -1;                        //!< /dev/videoN
+    std::string dev;                    //!< Gerätename für Meldungen
+    std::vector<struct _v4l2_buf_> bufs;    //!< eingeblendete Treiberpuffer
+    int width = 0, height = 0;          //!< vom Treiber eingestellte Bildgrösse
+    int stride = 0;                     //!< Bytes je Zeile (YUYV)
+    int pixfmt = 0;                     //!< PIXFMT_YUYV oder PIXFMT_MJPG
+    double fps = 0.0;                   //!< vom Treiber gemeldete Framerate
+    bool streaming = false;             //!< VIDIOC_STREAMON ist erfolgt
+};
+
+#endif
+
+//! @} v4l2_capture
@@ -4,8 +4,8 @@
 #define STR(x) STR2(x)
 
 #define VERSION_MAJOR 0
-#define VERSION_MINOR 9
-#define VERSION_PATCH 3
+#define VERSION_MINOR 10
+#define VERSION_PATCH 34
 
 #define VERSION ("v" STR(VERSION_MAJOR) "." STR(VERSION_MINOR) "." STR(VERSION_PATCH))
 // #define VERSION ("v" STR(VERSION_MAJOR) "." STR(VERSION_MINOR))
@@ -41,4 +41,42 @@ v0.9.0    ignor Area NEW
 v0.9.1    Funktion <int get_anzahl_sensetive_pixel()> NEW
 v0.9.2    Variable <anz_sensetive_pixel> ausgewertet.
 v0.9.3    histogram.h: Funktion stretch_BGR() NEW
+v0.9.4    Frame_Grabber.hpp NEW: Bildeinzug im eigenen Thread mit lock-freiem Ringpuffer (spsc_ring.hpp).
+v0.9.5    Save_Vid.hpp: Hintergrund-Modus mit Warteschlange. Option --vidqueue, --vidpolicy NEW.
+v0.9.6    Save_Vid.hpp: JPEG Pre-Roll vor dem Auslösen. Option --preroll, --prerollmem NEW.
+v0.10.0   class MotionDetector NEW. Bibliothek liblookat.a. Makefile: BUILD=release | debug.
+v0.10.1   Replay-Modus: Option --input (Video oder Verzeichnis), --csv NEW.
+v0.10.2   bench.cpp NEW: Micro-Benchmark je Stufe. make bench. MotionDetector::feed() NEW.
+v0.10.3   pixdiff.hpp NEW: absdiff, threshold und countNonZero in einem Durchlauf (AVX2/SSE2/NEON). make_seg() ohne seg_diff.
+v0.10.4   tile_blobs.hpp NEW: Blobs direkt auf dem Mosaik statt findContours(). Contour-Bild nur bei Bedarf.
+v0.10.5   Option --grid WxH NEW. Mosaik ohne Verlust am Rand. pixdiff::tiles() für 8x6, 16x12, 32x24 spezialisiert.
+v0.10.6   frame_ctx NEW: Puffer der Pipeline werden wiederverwendet, keine Allokation je Bild. Debug-Build zählt neu angelegte Puffer.
+v0.10.7   Option --lutcache NEW: Stretch-LUT aus dem Cache, neu nur alle n Bilder oder bei Helligkeitsänderung.
+v0.10.8   preproc.hpp NEW, Option --fastpre: Grau, ROI und 1. Verkleinerung in einem Durchlauf. Vergleich in lookat_bench.
+v0.10.9   morph.hpp NEW, Option --morph vhgw | cv: dilate/erode nach van Herk / Gil-Werman, O(1) je Pixel.
+v0.10.10  Option --pixfmt bgr | yuyv | mjpg NEW: Erkennung auf Y bzw. Grau-Dekodierung, BGR nur für Anzeige und Video.
+v0.10.11  v4l2_capture.hpp NEW, Option --capture cv | v4l2, --v4l2bufs: MMAP-Puffer ohne Kopie, Zeitstempel vom Kernel.
+v0.10.12  Option --fps, --idlefps NEW: Takt mit CLOCK_MONOTONIC statt usleep(MAX_DELAY), Rechenzeit wird abgezogen. Ruhiges Bild: --idlefps.
+v0.10.13  worker_pool.hpp NEW, --cam mehrfach: mehrere Kameras in einem Prozess, je Kamera eigene Pipeline und Unterverzeichnis cam<N>.
+v0.10.14  Option --threads NEW: Mosaik-Felder in Bändern parallel zählen (cv::parallel_for_), Ergebnis wie seriell. lookat_bench misst 1, 2, 4 Threads.
+v0.10.15  bg_model.hpp NEW, Option --bgmodel gauss | mean: Hintergrundmodell je Pixel (Festkomma) statt festem Hintergrundbild. Vordergrund-Pixel bestätigen die Falle.
+v0.10.16  Option --skip NEW: Vorfilter mit Vorschaubild 1/16. Ohne geändertes Feld wird die Auswertung übersprungen, spätestens jedes (skip+1). Bild voll.
+v0.10.17  sv_encoder.hpp NEW, Option --codec, --container, --bitrate, --gop: H.264 (v4l2m2m, x264, ffmpeg) mit Probe beim Start, sonst MJPG.
+v0.10.18  Video mit --fps statt fest 5 fps, Bilder nach Zeitstempel im Raster (Lücken wiederholt). Nachlauf und min/max-Zeit über Zeitstempel.
+v0.10.19  Option --record composite | raw NEW: raw speichert nur das Kamerabild, Zeitstempel, Differenz und Blobs als Untertitel (.vtt).
+v0.10.20  text_overlay.hpp NEW: Textzeile im Video aus vorgerenderten Masken. Datum/Uhrzeit einmal pro Sekunde, Zähler und Text aus dem Atlas.
+v0.10.21  storage.hpp NEW, Option --quota, --minfree: Index aller Videos über alle Tage, die ältesten Dateien löscht ein eigener Thread.
+v0.10.22  Contour-Bild max. 320x240 bei jedem --grid (vorher Faktor 40, Absturz bei grossem Mosaik).
+v0.10.23  check_pixdiff(): --pixdiff wird wirklich auf Mosaik-Fläche-1 begrenzt (feines --grid).
+v0.10.24  --threads stellt die Anzahl Threads ein (cv::setNumThreads), nicht nur die Anzahl Bänder. Mehrere Kameras: seriell.
+v0.10.25  Vorfilter: übersprungene Bilder nur alle 1000 ms in den Pre-Roll. Bench: idle mit Pre-Roll.
+v0.10.26  Encoder-Log: Bitrate und GOP nur bei v4l2m2m und x264, ffmpeg meldet sie als nicht wirksam.
+v0.10.27  storage: eine Datei, die erneut gemeldet wird (out_picture.avi), ersetzt ihren Eintrag statt ihn zu verdoppeln.
+v0.10.28  storage: --maxvideo wieder nur für die Videos dieses Laufs (save_video); ohne --quota/--minfree wird beim Start nichts gelöscht.
+v0.10.29  pixdiff::tiles(): Feldgrenzen für beliebiges --grid ohne Allokation je Bild.
+v0.10.30  save_video: Graustufenvideo (--gray) in eigene Puffer, keine Allokation je Bild.
+v0.10.31  --threads: cv::setNumThreads() einmal beim Start statt je Bild. Bench setzt ihn je Stufe einmal.
+v0.10.32  Vorfilter: grösste Abweichung je Feld statt Mittelwert (dünne Objekte), THUMB_THR 16, Fenster max. 1000 ms.
+v0.10.33  storage: Löschen und statvfs() ohne Sperre, Freiplatz einmal je Durchlauf gemessen.
+v0.10.34  storage: neueste Datei bleibt immer; --minfree nicht erreichbar: nichts löschen, Warnung im Log.
 */
@@ -0,0 +1,121 @@
+/*! ------------------------------------------
+ * @addtogroup worker_pool
+ * @{
+ *
+ * @file    worker_pool.cpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Implementierung der class @ref worker_pool.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <time.h>
+
+#include "worker_pool.hpp"
+
+/*! ----------------------------------------------
+ * @brief Monotone Zeit in [us]. Gleiche Zeitbasis wie @ref MotionDetector::get_due().
+ */
+long long worker_pool::now_us ()
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000ll + t.tv_nsec / 1000;
+}
+
+/*! ----------------------------------------------
+ * @brief Vergleich für den Heap: true, wenn a nach b dran ist.
+ */
+bool worker_pool::later (const struct _job_ &a, const struct _job_ &b)
+{
+    if (a.due != b.due)
+        return a.due > b.due;
+    return a.seq > b.seq;
+}
+
+/*! ----------------------------------------------
+ * @brief Worker-Threads starten.
+ * @param n Anzahl Threads. 0 = Anzahl CPU-Kerne.
+ */
+void worker_pool::start (int n)
+{
+    if (!th.empty())
+        return;         // läuft schon
+
+    if (n <= 0)
+        n = std::max (1u, std::thread::hardware_concurrency());
+    ende = false;
+    for (int i=0; i<n; i++)
+        th.push_back (new std::thread (run, this));
+}
+
+/*! ----------------------------------------------
+ * @brief Worker-Threads beenden. Laufende Aufträge werden fertig bearbeitet, wartende verworfen.
+ */
+void worker_pool::stop ()
+{
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        ende = true;
+    }
+    cv_job.notify_all();
+
+    for (size_t i=0; i<th.size(); i++) {
+        th[i]->join();
+        delete th[i];
+    }
+    th.clear();
+    jobs.clear();
+}
+
+/*! ----------------------------------------------
+ * @brief Auftrag einstellen.
+ * @param fn Auftrag
+ * @param due fällig ab CLOCK_MONOTONIC in [us], siehe @ref now_us(). 0 = sofort.
+ */
+void worker_pool::submit (std::function<void()> fn, long long due)
+{
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (ende)
+            return;
+        struct _job_ j = {due, seq++, std::move (fn)};
+        jobs.push_back (std::move (j));
+        std::push_heap (jobs.begin(), jobs.end(), later);
+    }
+    cv_job.notify_one();
+}
+
+/*! ----------------------------------------------
+ * @brief Thread: nimmt den Auftrag mit dem frühesten Termin, sobald er fällig ist.
+ */
+void worker_pool::run (worker_pool *p)
+{
+    std::unique_lock<std::mutex> lk(p->mtx);
+
+    while (!p->ende) {
+        if (p->jobs.empty()) {
+            p->cv_job.wait (lk);
+            continue;
+        }
+
+        long long wait = p->jobs.front().due - now_us();
+        if (wait > 0) {                 // noch nicht fällig. Ein früherer Auftrag weckt den Thread vorher.
+            p->cv_job.wait_for (lk, std::chrono::microseconds (wait));
+            continue;
+        }
+
+        std::pop_heap (p->jobs.begin(), p->jobs.end(), later);
+        std::function<void()> fn = std::move (p->jobs.back().fn);
+        p->jobs.pop_back ();
+
+        lk.unlock ();
+        fn ();
+        lk.lock ();
+    }
+}
+
+//! @} worker_pool
@@ -0,0 +1,68 @@
+/*! ------------------------------------------
+ * @defgroup worker_pool Worker_Pool: gemeinsame Threads für mehrere Kameras
+ * @{
+ *
+ * @file    worker_pool.hpp
+ * @author  Ulrich Buettemeier
+ * @date    2026-10-17
+ * @brief   Thread-Pool mit Terminen.\n
+ * Jeder Auftrag hat einen Fälligkeitszeitpunkt (CLOCK_MONOTONIC in [us]). Die Threads arbeiten die fälligen
+ * Aufträge in der Reihenfolge ihrer Termine ab und schlafen bis zum nächsten Termin.
+ * Bei mehreren Kameras (Option --cam mehrfach) stellt jede Pipeline ihren nächsten Schritt selbst wieder ein;
+ * so läuft je Kamera höchstens ein Auftrag gleichzeitig.
+ *
+ * @copyright Copyright (c) 2026 Ulrich Buettemeier, Stemwede
+ */
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! -------------------------------
+ * @brief Ein Auftrag mit Termin.
+ */
+struct _job_ {
+    long long due;                  //!< fällig ab CLOCK_MONOTONIC in [us]
+    uint64_t seq;                   //!< Reihenfolge bei gleichem Termin
+    std::function<void()> fn;       //!< Auftrag
+};
+
+/*! -------------------------------
+ * @brief class für einen Thread-Pool mit Terminen.
+ */
+class worker_pool {
+public:
+    worker_pool () {}
+    ~worker_pool () { stop (); }
+
+    worker_pool (worker_pool&) = delete;
+    void operator= (worker_pool&) = delete;
+
+    void start (int n = 0);
+    void stop ();
+    void submit (std::function<void()> fn, long long due = 0);
+    int size () { return (int)th.size(); }
+
+    static long long now_us ();
+
+private:
+    static void run (worker_pool *p);
+    static bool later (const struct _job_ &a, const struct _job_ &b);
+
+    std::vector<struct _job_> jobs;     //!< Heap, frühester Termin vorn. @see @ref later()
+    uint64_t seq = 0;                   //!< laufende Nr. für @ref _job_::seq
+    std::vector<std::thread *> th;      //!< Worker-Threads
+    bool ende = false;                  //!< true beendet die Worker-Threads
+    std::mutex mtx;                     //!< schützt jobs, seq und ende
+    std::condition_variable cv_job;     //!< neuer Auftrag oder Ende
+};
+
+#endif
+
+//! @} worker_pool